@@ -38,6 +38,15 @@
 #define MIN_BUFFER_SIZE 256        // Minimum buffer size in bytes (128 pixels)
 #define MAX_DISPLAY_WIDTH 320      // Maximum width among all supported displays
 #define MAX_DISPLAY_HEIGHT 240     // Maximum height among all supported displays
+#define ST7789_GRAM_LINES 320      // Frame memory lines along the gate (scan) direction
+
+/* Stroke vertices are Q4 in the int16 ST7789_Point_t. A miter tip sits up to
+ * ST7789_MITER_LIMIT half widths past a join inside the clip box grown by the
+ * miter reach, which must stay in range for the widest (UINT8_MAX) stroke. */
+#if ((MAX_DISPLAY_WIDTH - 1) * 16 + (ST7789_MITER_LIMIT * UINT8_MAX / 2 + 2) * 16 + \
+     ST7789_MITER_LIMIT * UINT8_MAX * 8) > INT16_MAX
+#error "ST7789_MITER_LIMIT is too large for Q4 stroke vertices, at most 6 fits"
+#endif
 
 /* Global runtime configuration */
 ST7789_Config_t st7789_config = {
@@ -60,6 +69,125 @@ uint16_t st7789_disp_buf_size = 0;  // Size in uint16_t elements (pixels)
 uint16_t st7789_dma_min_size = 16;
 #endif
 
+/* Vertical scrolling state.
+ * Fixed areas are counted in logical lines along the scan axis,
+ * the offset is the number of lines the scroll area content has moved
+ * towards the start of the axis.
+ */
+typedef struct {
+	uint16_t top_fixed;
+	uint16_t bottom_fixed;
+	uint16_t offset;
+	uint8_t enabled;
+} ST7789_ScrollState_t;
+
+static ST7789_ScrollState_t st7789_scroll = {0};
+
+/* GRAM page flipping state.
+ * A band of the screen is double buffered into the GRAM lines hidden
+ * next to it; the back copy lives back_offset lines away along the scan axis.
+ */
+typedef struct {
+	uint16_t band_start;
+	uint16_t band_lines;
+	int16_t back_offset;
+	uint8_t redirect;
+	uint8_t front;
+	uint8_t enabled;
+} ST7789_PageFlipState_t;
+
+static ST7789_PageFlipState_t st7789_page = {0};
+
+/* Partial display state, band given in logical lines along the scan axis */
+typedef struct {
+	uint16_t start;
+	uint16_t lines;
+	uint8_t enabled;
+} ST7789_PartialState_t;
+
+static ST7789_PartialState_t st7789_partial = {0};
+
+/* Drawing clip in logical coordinates (inclusive, empty when x0 > x1).
+ * Covers the screen, shrunk to the active band in partial mode and to the
+ * page flipping band while drawing off-screen.
+ */
+typedef struct {
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+} ST7789_ClipRect_t;
+
+static ST7789_ClipRect_t st7789_clip = {0, 0, 239, 239};
+
+/* Clip rectangle set by the application, intersected into st7789_clip */
+typedef struct {
+	ST7789_ClipRect_t rect;
+	uint8_t enabled;
+} ST7789_UserClipState_t;
+
+static ST7789_UserClipState_t st7789_user_clip = {0};
+
+/* Tearing effect synchronization state.
+ * te_count is advanced from the TE GPIO interrupt (or a simulated tick),
+ * which also runs the flush scheduled with ST7789_vsyncSchedule().
+ */
+typedef struct {
+	volatile uint32_t te_count;
+	uint32_t frame_te;
+	uint8_t enabled;
+	uint8_t in_frame;
+	volatile uint8_t pending;
+	ST7789_FlushFn_t flush;
+	void *flush_ctx;
+	ST7789_VsyncStats_t stats;
+} ST7789_VsyncState_t;
+
+static ST7789_VsyncState_t st7789_vsync = {0};
+
+/* Normal mode frame rates (Hz) for FRCTRL2 RTNA values 0x00-0x1F, default porch settings */
+static const uint8_t st7789_frame_rates[32] = {
+	119, 111, 105, 99, 94, 90, 86, 82, 78, 75, 72, 69, 67, 64, 62, 60,
+	58, 57, 55, 53, 52, 50, 49, 48, 46, 45, 44, 43, 42, 41, 40, 39
+};
+
+/* Frame pacing state.
+ * Frames start on slots one refresh period apart, tracked in ms plus a us remainder.
+ */
+typedef struct {
+	uint32_t period_us;
+	uint32_t slot_ms;
+	uint16_t slot_frac_us;
+	uint32_t start_ms;
+	uint8_t rate;
+	uint8_t running;
+	ST7789_FrameStats_t stats;
+} ST7789_PacingState_t;
+
+static ST7789_PacingState_t st7789_pacing = {
+	.period_us = 1000000 / 60,
+	.rate = 60
+};
+
+/* Span batch.
+ * Outline primitives collect their solid runs here, runs continuing the
+ * previous one are merged and each remaining span is sent as one window.
+ */
+#define ST7789_SPAN_BATCH_SIZE 16
+
+typedef struct {
+	ST7789_Rect_t spans[ST7789_SPAN_BATCH_SIZE];
+	uint8_t count;
+	uint16_t color;
+} ST7789_SpanBatch_t;
+
+static ST7789_SpanBatch_t st7789_spans = {0};
+
+#ifdef ST7789_USE_BUS_STATS
+/* Bus traffic counters */
+static ST7789_BusStats_t st7789_bus_stats = {0};
+#endif
+
 /**
  * @brief Write command to ST7789 controller
  * @param cmd -> command to write
@@ -67,6 +195,12 @@ uint16_t st7789_dma_min_size = 16;
  */
 static void ST7789_WriteCommand(uint8_t cmd)
 {
+#ifdef ST7789_USE_BUS_STATS
+	st7789_bus_stats.commands++;
+	if (cmd == ST7789_RAMWR) {
+		st7789_bus_stats.windows++;
+	}
+#endif
 	ST7789_Select();
 	ST7789_DC_Clr();
 	HAL_SPI_Transmit(&ST7789_SPI_PORT, &cmd, sizeof(cmd), HAL_MAX_DELAY);
@@ -81,6 +215,9 @@ static void ST7789_WriteCommand(uint8_t cmd)
  */
 static void ST7789_WriteData(uint8_t *buff, size_t buff_size)
 {
+#ifdef ST7789_USE_BUS_STATS
+	st7789_bus_stats.bytes += buff_size;
+#endif
 	ST7789_Select();
 	ST7789_DC_Set();
 
@@ -113,12 +250,177 @@ static void ST7789_WriteData(uint8_t *buff, size_t buff_size)
  */
 static void ST7789_WriteSmallData(uint8_t data)
 {
+#ifdef ST7789_USE_BUS_STATS
+	st7789_bus_stats.bytes++;
+#endif
 	ST7789_Select();
 	ST7789_DC_Set();
 	HAL_SPI_Transmit(&ST7789_SPI_PORT, &data, sizeof(data), HAL_MAX_DELAY);
 	ST7789_UnSelect();
 }
 
+/**
+ * @brief Write RGB565 pixels, converting them to big-endian through the display buffer
+ * @param data -> pointer to pixels in MCU byte order
+ * @param count -> number of pixels
+ * @return none
+ */
+static void ST7789_WritePixels(const uint16_t *data, uint32_t count)
+{
+	while (count > 0) {
+		uint16_t chunk = (count > st7789_disp_buf_size) ? st7789_disp_buf_size : count;
+
+		for (uint16_t i = 0; i < chunk; i++) {
+			uint16_t pixel = data[i];
+			st7789_disp_buf[i] = (pixel >> 8) | (pixel << 8);
+		}
+
+		ST7789_WriteData((uint8_t*)st7789_disp_buf, chunk * 2);
+		data += chunk;
+		count -= chunk;
+	}
+}
+
+/**
+ * @brief Write rows of an image to the open window, packing them into the display buffer
+ * @param data -> first pixel of the first row (MCU byte order)
+ * @param stride -> pixels between the starts of two rows
+ * @param len -> pixels per row
+ * @param rows -> number of rows
+ * @return none
+ */
+static void ST7789_WriteRows(const uint16_t *data, uint16_t stride, uint16_t len, uint16_t rows)
+{
+	if (len > st7789_disp_buf_size) {
+		for (uint16_t row = 0; row < rows; row++, data += stride) {
+			ST7789_WritePixels(data, len);
+		}
+		return;
+	}
+
+	uint16_t fill = 0;
+	for (uint16_t row = 0; row < rows; row++, data += stride) {
+		if (fill + len > st7789_disp_buf_size) {
+			ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+			fill = 0;
+		}
+		for (uint16_t i = 0; i < len; i++) {
+			uint16_t pixel = data[i];
+			st7789_disp_buf[fill++] = (pixel >> 8) | (pixel << 8);
+		}
+	}
+	ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+}
+
+/**
+ * @brief Blend two RGB565 colors
+ * @param fg -> foreground color
+ * @param bg -> background color
+ * @param alpha -> foreground opacity (0-255)
+ * @return Blended color
+ * @note Channels are spread as 0x07E0F81F (green in the upper half word)
+ *       so one multiply of the difference blends all three with 5-bit alpha
+ *       precision. Borrows between channels cancel once bg is added back.
+ */
+static inline uint16_t ST7789_BlendColor(uint16_t fg, uint16_t bg, uint8_t alpha)
+{
+	uint32_t a = (alpha + 4) >> 3;
+	uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+	uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+	uint32_t c = ((((f - b) * a) >> 5) + b) & 0x07E0F81F;
+
+	return (uint16_t)(c | (c >> 16));
+}
+
+/**
+ * @brief Blend two pairs of RGB565 pixels with one opacity
+ * @param fg -> two foreground pixels, first one in the lower half word
+ * @param bg -> two background pixels
+ * @param a -> foreground opacity (0-32)
+ * @return Two blended pixels
+ * @note The six channels are split over three words, each holding one
+ *       channel of both pixels with five spare bits above it, so every
+ *       multiply blends two pixels: blue 0 and green 1 (0x07E0001F), red 0
+ *       and red 1 (0x001F001F after >> 11), green 0 and blue 1 (0x0000F83F
+ *       after >> 5). Results match ST7789_BlendColor() exactly.
+ */
+static inline uint32_t ST7789_BlendPair(uint32_t fg, uint32_t bg, uint32_t a)
+{
+	uint32_t f0 = fg & 0x07E0001F, b0 = bg & 0x07E0001F;
+	uint32_t f1 = (fg >> 11) & 0x001F001F, b1 = (bg >> 11) & 0x001F001F;
+	uint32_t f2 = (fg >> 5) & 0x0000F83F, b2 = (bg >> 5) & 0x0000F83F;
+
+	uint32_t c0 = ((((f0 - b0) * a) >> 5) + b0) & 0x07E0001F;
+	uint32_t c1 = ((((f1 - b1) * a) >> 5) + b1) & 0x001F001F;
+	uint32_t c2 = ((((f2 - b2) * a) >> 5) + b2) & 0x0000F83F;
+
+	return c0 | (c1 << 11) | (c2 << 5);
+}
+
+/**
+ * @brief Blend a row of pixels over a destination row
+ * @param dst -> destination pixels, blended in place
+ * @param src -> source pixels
+ * @param alpha -> alpha channel of the source row (unused for ST7789_ALPHA_CONST)
+ * @param col -> column of src[0] in the source row, selects the A4 nibble
+ * @param n -> number of pixels
+ * @param format -> alpha channel format
+ * @param opacity -> constant opacity applied on top of the alpha channel (0-255)
+ * @return none
+ * @note Constant opacity blends two pixels per 32-bit word with
+ *       ST7789_BlendPair(), the odd pixel left goes through
+ *       ST7789_BlendColor(). With an alpha channel every pixel has its own
+ *       opacity and is blended alone. Transparent pixels are skipped and
+ *       opaque ones copied.
+ */
+static void ST7789_BlendRow(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, uint16_t col,
+                            uint16_t n, ST7789_AlphaFormat_t format, uint8_t opacity)
+{
+	uint32_t scale = (uint32_t)opacity + 1;
+
+	if (format == ST7789_ALPHA_CONST) {
+		uint32_t a = (opacity + 4) >> 3;
+		uint16_t i = 0;
+
+		if (a == 0) return;
+		if (a == 32) {
+			memcpy(dst, src, n * sizeof(uint16_t));
+			return;
+		}
+
+		// Rows need not be word aligned, memcpy keeps the word accesses legal
+		for (; i + 1 < n; i += 2) {
+			uint32_t fg, bg;
+			memcpy(&fg, &src[i], sizeof(fg));
+			memcpy(&bg, &dst[i], sizeof(bg));
+			bg = ST7789_BlendPair(fg, bg, a);
+			memcpy(&dst[i], &bg, sizeof(bg));
+		}
+		if (i < n) {
+			dst[i] = ST7789_BlendColor(src[i], dst[i], opacity);
+		}
+		return;
+	}
+
+	for (uint16_t i = 0; i < n; i++, col++) {
+		uint8_t value;
+		if (format == ST7789_ALPHA_A8) {
+			value = alpha[col] * scale >> 8;
+		} else {
+			uint8_t nibble = (col & 1) ? (alpha[col >> 1] & 0x0F) : (alpha[col >> 1] >> 4);
+			value = nibble * 17 * scale >> 8;
+		}
+
+		// Same rounding as ST7789_BlendColor() to 5-bit alpha
+		if (value < 4) continue;
+		if (value >= 252) {
+			dst[i] = src[i];
+			continue;
+		}
+		dst[i] = ST7789_BlendColor(src[i], dst[i], value);
+	}
+}
+
 /**
  * @brief Check if display is initialized
  * @return 1 if initialized, 0 otherwise
@@ -255,6 +557,79 @@ static void ST7789_CalculateDisplayParams(ST7789_DisplayType_t type, uint8_t rot
 	}
 }
 
+/**
+ * @brief Restrict the drawing clip to a band along the scan axis
+ * @param first -> first logical line of the band
+ * @param last -> last logical line of the band
+ * @return none
+ */
+static void ST7789_ClipScanAxis(int16_t first, int16_t last)
+{
+	if (st7789_config.rotation & 1) {
+		if (first > st7789_clip.x0) st7789_clip.x0 = first;
+		if (last < st7789_clip.x1) st7789_clip.x1 = last;
+	} else {
+		if (first > st7789_clip.y0) st7789_clip.y0 = first;
+		if (last < st7789_clip.y1) st7789_clip.y1 = last;
+	}
+}
+
+/**
+ * @brief Recalculate the drawing clip from screen size, partial mode and page flipping
+ * @return none
+ */
+static void ST7789_UpdateClip(void)
+{
+	st7789_clip.x0 = 0;
+	st7789_clip.y0 = 0;
+	st7789_clip.x1 = ST7789_WIDTH - 1;
+	st7789_clip.y1 = ST7789_HEIGHT - 1;
+
+	// Lines outside the partial area are not scanned, don't spend bus time on them
+	if (st7789_partial.enabled) {
+		ST7789_ClipScanAxis(st7789_partial.start, st7789_partial.start + st7789_partial.lines - 1);
+	}
+
+	// Redirected drawing must stay inside the double buffered band
+	if (st7789_page.redirect) {
+		ST7789_ClipScanAxis(st7789_page.band_start, st7789_page.band_start + st7789_page.band_lines - 1);
+	}
+
+	if (st7789_user_clip.enabled) {
+		if (st7789_user_clip.rect.x0 > st7789_clip.x0) st7789_clip.x0 = st7789_user_clip.rect.x0;
+		if (st7789_user_clip.rect.y0 > st7789_clip.y0) st7789_clip.y0 = st7789_user_clip.rect.y0;
+		if (st7789_user_clip.rect.x1 < st7789_clip.x1) st7789_clip.x1 = st7789_user_clip.rect.x1;
+		if (st7789_user_clip.rect.y1 < st7789_clip.y1) st7789_clip.y1 = st7789_user_clip.rect.y1;
+	}
+}
+
+/**
+ * @brief Clip an area against the drawing clip
+ * @param x&y -> pointers to the top-left corner, updated in place
+ * @param w&h -> pointers to width & height, updated in place
+ * @return 1 if part of the area is left to draw, 0 otherwise
+ */
+static uint8_t ST7789_ClipArea(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h)
+{
+	if (*w == 0 || *h == 0) return 0;
+
+	int32_t x0 = *x, y0 = *y;
+	int32_t x1 = x0 + *w - 1, y1 = y0 + *h - 1;
+
+	if (x0 < st7789_clip.x0) x0 = st7789_clip.x0;
+	if (y0 < st7789_clip.y0) y0 = st7789_clip.y0;
+	if (x1 > st7789_clip.x1) x1 = st7789_clip.x1;
+	if (y1 > st7789_clip.y1) y1 = st7789_clip.y1;
+
+	if (x0 > x1 || y0 > y1) return 0;
+
+	*x = x0;
+	*y = y0;
+	*w = x1 - x0 + 1;
+	*h = y1 - y0 + 1;
+	return 1;
+}
+
 /**
  * @brief Set the rotation direction of the display
  * @param m -> rotation parameter(please refer it in st7789.h)
@@ -288,19 +663,64 @@ void ST7789_setRotation(uint8_t m)
 	default:
 		break;
 	}
+
+	// Band geometry depends on the scan axis, page flipping has to be set up again
+	if (st7789_page.enabled) {
+		ST7789_pageFlipDisable();
+	}
+
+	// Partial area is defined in gate lines too, move it to the new scan axis
+	if (st7789_partial.enabled) {
+		if (ST7789_setPartialArea(st7789_partial.start, st7789_partial.lines) != ST7789_OK) {
+			ST7789_setNormalMode();
+		}
+	}
+	ST7789_UpdateClip();
+
+	// Scroll area depends on the scan axis, rebuild it for the new orientation
+	if (st7789_scroll.enabled) {
+		ST7789_setScrollArea(st7789_scroll.top_fixed, st7789_scroll.bottom_fixed);
+	}
 }
 
 /**
- * @brief Set address of DisplayWindow
+ * @brief Get the GRAM offset of a range of lines along the scan axis
+ * @param first&last -> logical lines of the range
+ * @return Lines to add to the GRAM address, 0 outside the page flipping band
+ * @note Normal drawing goes to the page on screen and redirected drawing to
+ *       the other one. After an odd number of flips the copy is on screen.
+ */
+static int16_t ST7789_PageOffset(uint16_t first, uint16_t last)
+{
+	if (!st7789_page.enabled) return 0;
+	if (first < st7789_page.band_start || last >= st7789_page.band_start + st7789_page.band_lines) return 0;
+
+	uint8_t back = st7789_page.redirect ? !st7789_page.front : st7789_page.front;
+	return back ? st7789_page.back_offset : 0;
+}
+
+/**
+ * @brief Set column and row address range without starting a memory access
  * @param xi&yi -> coordinates of window
  * @return none
  */
-static void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+static void ST7789_SetAddressRange(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
 	ST7789_Select();
 	uint16_t x_start = x0 + ST7789_X_SHIFT, x_end = x1 + ST7789_X_SHIFT;
 	uint16_t y_start = y0 + ST7789_Y_SHIFT, y_end = y1 + ST7789_Y_SHIFT;
 
+	/* Band lines live in the page selected by page flipping */
+	if (st7789_config.rotation & 1) {
+		int16_t offset = ST7789_PageOffset(x0, x1);
+		x_start += offset;
+		x_end += offset;
+	} else {
+		int16_t offset = ST7789_PageOffset(y0, y1);
+		y_start += offset;
+		y_end += offset;
+	}
+
 	/* Column Address set */
 	ST7789_WriteCommand(ST7789_CASET);
 	{
@@ -314,11 +734,97 @@ static void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint1
 		uint8_t data[] = {y_start >> 8, y_start & 0xFF, y_end >> 8, y_end & 0xFF};
 		ST7789_WriteData(data, sizeof(data));
 	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Set address of DisplayWindow
+ * @param xi&yi -> coordinates of window
+ * @return none
+ */
+static void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+	ST7789_Select();
+	ST7789_SetAddressRange(x0, y0, x1, y1);
 	/* Write to RAM */
 	ST7789_WriteCommand(ST7789_RAMWR);
 	ST7789_UnSelect();
 }
 
+/**
+ * @brief Move the columns of the current window and start a new memory write
+ * @param x0&x1 -> first and last column
+ * @return none
+ * @note Rows stay as set by the last ST7789_SetAddressWindow(), saving the
+ *       RASET when several windows are sent on the same row
+ */
+static void ST7789_SetColumnWindow(uint16_t x0, uint16_t x1)
+{
+	uint16_t x_start = x0 + ST7789_X_SHIFT, x_end = x1 + ST7789_X_SHIFT;
+
+	/* The pages are along x in rotation 1/3, rows keep their offset otherwise */
+	if (st7789_config.rotation & 1) {
+		int16_t offset = ST7789_PageOffset(x0, x1);
+		x_start += offset;
+		x_end += offset;
+	}
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_CASET);
+	{
+		uint8_t data[] = {x_start >> 8, x_start & 0xFF, x_end >> 8, x_end & 0xFF};
+		ST7789_WriteData(data, sizeof(data));
+	}
+	ST7789_WriteCommand(ST7789_RAMWR);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Read a window of GRAM back, converting RGB666 to RGB565
+ * @param xi&yi -> coordinates of window
+ * @param dest -> pointer to store pixels (RGB565, MCU byte order)
+ * @param count -> number of pixels to read
+ * @return none
+ * @note Switches the SPI clock to ST7789_SPI_READ_PRESCALER for the transfer.
+ *       CS stays low from RAMRD to the last byte, raising it ends the read.
+ */
+static void ST7789_ReadWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t *dest, uint32_t count)
+{
+	uint32_t prescaler = ST7789_SPI_PORT.Init.BaudRatePrescaler;
+	uint8_t cmd = ST7789_RAMRD;
+	uint8_t rgb[48];	// 16 pixels per receive
+
+	ST7789_SetAddressRange(x0, y0, x1, y1);
+
+	ST7789_SPI_PORT.Init.BaudRatePrescaler = ST7789_SPI_READ_PRESCALER;
+	HAL_SPI_Init(&ST7789_SPI_PORT);
+
+	ST7789_Select();
+	ST7789_DC_Clr();
+	HAL_SPI_Transmit(&ST7789_SPI_PORT, &cmd, sizeof(cmd), HAL_MAX_DELAY);
+	ST7789_DC_Set();
+
+	// First byte after RAMRD is a dummy read
+	HAL_SPI_Receive(&ST7789_SPI_PORT, rgb, 1, HAL_MAX_DELAY);
+
+	while (count > 0) {
+		uint16_t chunk = (count > sizeof(rgb) / 3) ? sizeof(rgb) / 3 : count;
+
+		HAL_SPI_Receive(&ST7789_SPI_PORT, rgb, chunk * 3, HAL_MAX_DELAY);
+		for (uint16_t i = 0; i < chunk; i++) {
+			// Each channel is returned in the upper 6 bits of a byte
+			uint8_t *p = &rgb[i * 3];
+			*dest++ = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+		}
+		count -= chunk;
+	}
+
+	ST7789_UnSelect();
+
+	ST7789_SPI_PORT.Init.BaudRatePrescaler = prescaler;
+	HAL_SPI_Init(&ST7789_SPI_PORT);
+}
+
 /**
  * @brief Initialize ST7789 controller with runtime parameters
  * @param display_type -> type of display (135x240, 240x240, or 170x320)
@@ -350,6 +856,16 @@ ST7789_Status_t ST7789_init(ST7789_DisplayType_t display_type, uint8_t rotation,
 	st7789_config.display_type = display_type;
 	st7789_config.rotation = rotation;
 
+	// Hardware reset restores the default (disabled) scroll area
+	memset(&st7789_scroll, 0, sizeof(st7789_scroll));
+	memset(&st7789_page, 0, sizeof(st7789_page));
+	memset(&st7789_partial, 0, sizeof(st7789_partial));
+	memset(&st7789_user_clip, 0, sizeof(st7789_user_clip));
+	memset(&st7789_vsync, 0, sizeof(st7789_vsync));
+	memset(&st7789_pacing, 0, sizeof(st7789_pacing));
+	st7789_pacing.rate = 60;
+	st7789_pacing.period_us = 1000000 / 60;
+
 	// Calculate parameters internally
 	ST7789_CalculateDisplayParams(display_type, rotation,
 	                               &st7789_config.width, &st7789_config.height,
@@ -485,9 +1001,10 @@ void ST7789_fillScreen(uint16_t color)
  * @return none
  * @note Caller must handle ST7789_Select/UnSelect
  */
-static inline void ST7789_DrawPixel_Internal(uint16_t x, uint16_t y, uint16_t color)
+static inline void ST7789_DrawPixel_Internal(int16_t x, int16_t y, uint16_t color)
 {
-	if ((x >= ST7789_WIDTH) || (y >= ST7789_HEIGHT))
+	if ((x < st7789_clip.x0) || (x > st7789_clip.x1) ||
+	    (y < st7789_clip.y0) || (y > st7789_clip.y1))
 		return;
 
 	ST7789_SetAddressWindow(x, y, x, y);
@@ -501,7 +1018,7 @@ static inline void ST7789_DrawPixel_Internal(uint16_t x, uint16_t y, uint16_t co
  * @param color -> color of the Pixel
  * @return none
  */
-void ST7789_drawPixel(uint16_t x, uint16_t y, uint16_t color)
+void ST7789_drawPixel(int16_t x, int16_t y, uint16_t color)
 {
 	if (!ST7789_isInitialized()) return;
 	ST7789_Select();
@@ -510,172 +1027,646 @@ void ST7789_drawPixel(uint16_t x, uint16_t y, uint16_t color)
 }
 
 /**
- * @brief Internal helper to draw a line without CS control
- * @param x1&y1 -> coordinate of the start point
- * @param x2&y2 -> coordinate of the end point
- * @param color -> color of the line to Draw
- * @return none
- * @note Caller must handle ST7789_Select/UnSelect
+ * @brief Check whether a point sorts after another, by row, column, then index
+ * @param points -> array of points
+ * @param a&b -> indices of the points
+ * @return 1 if points[a] comes after points[b], 0 otherwise
  */
-static void ST7789_DrawLine_Internal(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+static inline uint8_t ST7789_PointAfter(const ST7789_Point_t *points, uint16_t a, uint16_t b)
 {
-	uint16_t swap;
-    uint16_t steep = abs(y1 - y0) > abs(x1 - x0);
-    if (steep) {
-		swap = x0;
-		x0 = y0;
-		y0 = swap;
-
-		swap = x1;
-		x1 = y1;
-		y1 = swap;
-    }
-
-    if (x0 > x1) {
-		swap = x0;
-		x0 = x1;
-		x1 = swap;
-
-		swap = y0;
-		y0 = y1;
-		y1 = swap;
-    }
+	if (points[a].y != points[b].y) return points[a].y > points[b].y;
+	if (points[a].x != points[b].x) return points[a].x > points[b].x;
+	return a > b;
+}
 
-    int16_t dx, dy;
-    dx = x1 - x0;
-    dy = abs(y1 - y0);
+/**
+ * @brief Sort point indices by row, column, then index (heapsort, in place)
+ * @param points -> array of points
+ * @param idx -> indices into points
+ * @param n -> number of indices
+ * @return none
+ */
+static void ST7789_SortPoints(const ST7789_Point_t *points, uint16_t *idx, uint16_t n)
+{
+	for (uint16_t end = n, start = n / 2; end > 1; ) {
+		uint16_t root;
 
-    int16_t err = dx / 2;
-    int16_t ystep;
+		if (start > 0) {
+			// Build the heap
+			root = --start;
+		} else {
+			// Move the largest to the end and restore the heap
+			uint16_t swap = idx[--end];
+			idx[end] = idx[0];
+			idx[0] = swap;
+			root = 0;
+		}
 
-    if (y0 < y1) {
-        ystep = 1;
-    } else {
-        ystep = -1;
-    }
+		for (uint16_t child; (child = 2 * root + 1) < end; root = child) {
+			if (child + 1 < end && ST7789_PointAfter(points, idx[child + 1], idx[child])) {
+				child++;
+			}
+			if (!ST7789_PointAfter(points, idx[child], idx[root])) break;
 
-    for (; x0<=x1; x0++) {
-        if (steep) {
-            ST7789_DrawPixel_Internal(y0, x0, color);
-        } else {
-            ST7789_DrawPixel_Internal(x0, y0, color);
-        }
-        err -= dy;
-        if (err < 0) {
-            y0 += ystep;
-            err += dx;
-        }
-    }
+			uint16_t swap = idx[root];
+			idx[root] = idx[child];
+			idx[child] = swap;
+		}
+	}
 }
 
 /**
- * @brief Draw a line with single color
- * @param x1&y1 -> coordinate of the start point
- * @param x2&y2 -> coordinate of the end point
- * @param color -> color of the line to Draw
+ * @brief Send a run of pixels on one row
+ * @param x&y -> first pixel of the run
+ * @param data -> pixels (RGB565, big-endian)
+ * @param len -> number of pixels
+ * @param row -> row of the window last set up, updated
  * @return none
+ * @note Only the columns are set again when the row is unchanged.
+ *       Caller must handle ST7789_Select/UnSelect
  */
-void ST7789_drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+static void ST7789_PixelRun(int16_t x, int16_t y, const uint16_t *data, uint16_t len, int32_t *row)
 {
-	if (!ST7789_isInitialized()) return;
-    ST7789_Select();
-    ST7789_DrawLine_Internal(x0, y0, x1, y1, color);
-    ST7789_UnSelect();
+	if (*row == y) {
+		ST7789_SetColumnWindow(x, x + len - 1);
+	} else {
+		ST7789_SetAddressWindow(x, y, x + len - 1, y);
+		*row = y;
+	}
+	ST7789_WriteData((uint8_t*)data, len * 2);
 }
 
 /**
- * @brief Draw a fast horizontal line (optimized for axis-aligned lines)
- * @param x -> starting x coordinate
- * @param y -> y coordinate (constant for horizontal line)
- * @param w -> width (length of line in pixels)
- * @param color -> color of the line
+ * @brief Draw many single pixels
+ * @param points -> array of points
+ * @param count -> number of points
+ * @param colors -> color of each point, NULL to draw all in color
+ * @param color -> color of the points when colors is NULL
  * @return none
+ * @note Points are taken in batches as large as st7789_disp_buf. The batch
+ *       is sorted by row and column, points next to each other on a row
+ *       are merged into runs and each run is sent as one window, with only
+ *       CASET between runs on the same row. Run pixels are packed over the
+ *       sorted indices already consumed. When a point
+ *       is repeated the later one wins, as with ST7789_drawPixel() calls.
  */
-void ST7789_drawFastHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
+void ST7789_drawPixels(const ST7789_Point_t *points, uint16_t count, const uint16_t *colors, uint16_t color)
 {
 	if (!ST7789_isInitialized()) return;
+	if (points == NULL) return;
 
-	// Bounds checking
-	if (y >= ST7789_HEIGHT) return;
-	if (x >= ST7789_WIDTH) return;
-
-	// Clip width to screen boundary
-	if (x + w > ST7789_WIDTH) {
-		w = ST7789_WIDTH - x;
-	}
-
-	if (w == 0) return;
+	uint16_t *idx = st7789_disp_buf;
+	int32_t row = -1;
 
 	ST7789_Select();
-
-	// Set address window for single row
-	ST7789_SetAddressWindow(x, y, x + w - 1, y);
-
-	// Fill line using buffer for efficiency
-	uint16_t pixels_to_draw = w;
-	uint16_t color_swapped = (color >> 8) | (color << 8);
-
-	while (pixels_to_draw > 0) {
-		uint16_t chunk = (pixels_to_draw > st7789_disp_buf_size) ? st7789_disp_buf_size : pixels_to_draw;
-
-		// Fill buffer with color
-		for (uint16_t i = 0; i < chunk; i++) {
-			st7789_disp_buf[i] = color_swapped;
+	for (uint16_t base = 0; base < count; ) {
+		const ST7789_Point_t *batch = &points[base];
+		uint16_t take = ((count - base) > st7789_disp_buf_size) ? st7789_disp_buf_size : (count - base);
+		uint16_t n = 0;
+
+		for (uint16_t i = 0; i < take; i++) {
+			if (batch[i].x >= st7789_clip.x0 && batch[i].x <= st7789_clip.x1 &&
+			    batch[i].y >= st7789_clip.y0 && batch[i].y <= st7789_clip.y1) {
+				idx[n++] = i;
+			}
 		}
+		ST7789_SortPoints(batch, idx, n);
+
+		int16_t run_x = 0, run_y = 0;
+		uint16_t run = 0, len = 0;
+		for (uint16_t i = 0; i < n; i++) {
+			const ST7789_Point_t *p = &batch[idx[i]];
+			uint16_t pixel = (colors != NULL) ? colors[base + idx[i]] : color;
+			pixel = (pixel >> 8) | (pixel << 8);
+
+			// Slots up to i are consumed, the run is packed from slot run on
+			if (len > 0 && p->y == run_y && p->x == run_x + len - 1) {
+				idx[run + len - 1] = pixel;
+				continue;
+			}
+			if (len > 0 && p->y == run_y && p->x == run_x + len) {
+				idx[run + len++] = pixel;
+				continue;
+			}
 
-		// Send chunk
-		ST7789_WriteData((uint8_t*)st7789_disp_buf, chunk * 2);
-		pixels_to_draw -= chunk;
+			if (len > 0) {
+				ST7789_PixelRun(run_x, run_y, &idx[run], len, &row);
+			}
+			run = i;
+			run_x = p->x;
+			run_y = p->y;
+			idx[run] = pixel;
+			len = 1;
+		}
+		if (len > 0) {
+			ST7789_PixelRun(run_x, run_y, &idx[run], len, &row);
+		}
+		base += take;
 	}
-
 	ST7789_UnSelect();
 }
 
 /**
- * @brief Draw a fast vertical line (optimized for axis-aligned lines)
- * @param x -> x coordinate (constant for vertical line)
- * @param y -> starting y coordinate
- * @param h -> height (length of line in pixels)
- * @param color -> color of the line
+ * @brief Internal helper to fill an area with one color without CS control
+ * @param x&y -> top-left corner of the area
+ * @param w&h -> width & height of the area
+ * @param color -> fill color
  * @return none
+ * @note Clips to the drawing area and sends the area as a single window.
+ *       Caller must handle ST7789_Select/UnSelect
  */
-void ST7789_drawFastVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
+static void ST7789_FillArea_Internal(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
-	if (!ST7789_isInitialized()) return;
-
-	// Bounds checking
-	if (x >= ST7789_WIDTH) return;
-	if (y >= ST7789_HEIGHT) return;
-
-	// Clip height to screen boundary
-	if (y + h > ST7789_HEIGHT) {
-		h = ST7789_HEIGHT - y;
+	if (!ST7789_ClipArea(&x, &y, &w, &h)) return;
+
+	// After an odd number of flips only the band moves to the copy, split at its edges
+	if (st7789_page.enabled && st7789_page.front && !st7789_page.redirect) {
+		int16_t first = (st7789_config.rotation & 1) ? x : y;
+		int16_t last = first + ((st7789_config.rotation & 1) ? w : h) - 1;
+		int16_t cut = st7789_page.band_start;
+		if (first >= cut || last < cut) cut += st7789_page.band_lines;
+
+		if (first < cut && last >= cut) {
+			if (st7789_config.rotation & 1) {
+				ST7789_FillArea_Internal(x, y, cut - x, h, color);
+				ST7789_FillArea_Internal(cut, y, last - cut + 1, h, color);
+			} else {
+				ST7789_FillArea_Internal(x, y, w, cut - y, color);
+				ST7789_FillArea_Internal(x, cut, w, last - cut + 1, color);
+			}
+			return;
+		}
 	}
 
-	if (h == 0) return;
-
-	ST7789_Select();
-
-	// Set address window for single column
-	ST7789_SetAddressWindow(x, y, x, y + h - 1);
-
-	// Fill line using buffer for efficiency
-	uint16_t pixels_to_draw = h;
+	uint32_t pixels = (uint32_t)w * h;
+	uint16_t fill = (pixels > st7789_disp_buf_size) ? st7789_disp_buf_size : pixels;
 	uint16_t color_swapped = (color >> 8) | (color << 8);
 
-	while (pixels_to_draw > 0) {
-		uint16_t chunk = (pixels_to_draw > st7789_disp_buf_size) ? st7789_disp_buf_size : pixels_to_draw;
+	// Only fill as much of the buffer as the area needs
+	for (uint16_t i = 0; i < fill; i++) {
+		st7789_disp_buf[i] = color_swapped;
+	}
 
-		// Fill buffer with color
-		for (uint16_t i = 0; i < chunk; i++) {
-			st7789_disp_buf[i] = color_swapped;
+	ST7789_SetAddressWindow(x, y, x + w - 1, y + h - 1);
+	while (pixels > 0) {
+		uint16_t chunk = (pixels > fill) ? fill : pixels;
+		ST7789_WriteData((uint8_t*)st7789_disp_buf, chunk * 2);
+		pixels -= chunk;
+	}
+}
+
+/**
+ * @brief Send the collected spans, one window each
+ * @return none
+ * @note Caller must handle ST7789_Select/UnSelect
+ */
+static void ST7789_SpanFlush(void)
+{
+	for (uint8_t i = 0; i < st7789_spans.count; i++) {
+		ST7789_Rect_t *span = &st7789_spans.spans[i];
+		ST7789_FillArea_Internal(span->x, span->y, span->w, span->h, st7789_spans.color);
+	}
+	st7789_spans.count = 0;
+}
+
+/**
+ * @brief Add a solid span to the span batch
+ * @param x&y -> top-left corner of the span
+ * @param w&h -> width & height of the span
+ * @param color -> span color
+ * @return none
+ * @note The span is clipped to the drawing area and merged with the previous
+ *       one when they continue each other. The batch is flushed when full
+ *       or when the color changes, callers flush it when done.
+ *       Caller must handle ST7789_Select/UnSelect
+ */
+static void ST7789_SpanAdd(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+	int32_t x1 = x + w - 1, y1 = y + h - 1;
+
+	if (x < st7789_clip.x0) x = st7789_clip.x0;
+	if (y < st7789_clip.y0) y = st7789_clip.y0;
+	if (x1 > st7789_clip.x1) x1 = st7789_clip.x1;
+	if (y1 > st7789_clip.y1) y1 = st7789_clip.y1;
+	if (x > x1 || y > y1) return;
+	w = x1 - x + 1;
+	h = y1 - y + 1;
+
+	if (st7789_spans.count > 0 && st7789_spans.color != color) {
+		ST7789_SpanFlush();
+	}
+	st7789_spans.color = color;
+
+	if (st7789_spans.count > 0) {
+		ST7789_Rect_t *last = &st7789_spans.spans[st7789_spans.count - 1];
+
+		// Same columns on the next rows, or same rows on the next columns
+		if (last->x == x && last->w == w && last->y + last->h == y) {
+			last->h += h;
+			return;
 		}
+		if (last->y == y && last->h == h && last->x + last->w == x) {
+			last->w += w;
+			return;
+		}
+	}
 
-		// Send chunk
-		ST7789_WriteData((uint8_t*)st7789_disp_buf, chunk * 2);
-		pixels_to_draw -= chunk;
+	if (st7789_spans.count == ST7789_SPAN_BATCH_SIZE) {
+		ST7789_SpanFlush();
+	}
+
+	ST7789_Rect_t *span = &st7789_spans.spans[st7789_spans.count++];
+	span->x = x;
+	span->y = y;
+	span->w = w;
+	span->h = h;
+}
+
+/* Line end points drawn by ST7789_DrawLine_Internal */
+#define ST7789_LINE_START 0x01
+#define ST7789_LINE_END   0x02
+#define ST7789_LINE_BOTH  (ST7789_LINE_START | ST7789_LINE_END)
+
+/**
+ * @brief Internal helper to draw a line into the span batch
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line to Draw
+ * @param ends -> ST7789_LINE_START/ST7789_LINE_END to include the end points,
+ *                polylines leave out points shared with the previous segment
+ * @return none
+ * @note Bresenham steps are grouped into horizontal (or vertical, for steep
+ *       lines) runs and each run becomes one span. Axis-aligned lines are a
+ *       single span. Caller must flush the span batch.
+ */
+static void ST7789_DrawLine_Internal(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color, uint8_t ends)
+{
+	int16_t swap;
+	uint8_t steep = abs(y1 - y0) > abs(x1 - x0);
+	if (steep) {
+		swap = x0;
+		x0 = y0;
+		y0 = swap;
+
+		swap = x1;
+		x1 = y1;
+		y1 = swap;
+	}
+
+	if (x0 > x1) {
+		swap = x0;
+		x0 = x1;
+		x1 = swap;
+
+		swap = y0;
+		y0 = y1;
+		y1 = swap;
+
+		ends = ((ends & ST7789_LINE_START) ? ST7789_LINE_END : 0) | ((ends & ST7789_LINE_END) ? ST7789_LINE_START : 0);
+	}
+
+	// Pixels left out at either end
+	int32_t lo = (ends & ST7789_LINE_START) ? x0 : x0 + 1;
+	int32_t hi = (ends & ST7789_LINE_END) ? x1 : x1 - 1;
+
+	int32_t dx = x1 - x0;
+	int32_t dy = abs(y1 - y0);
+	int32_t half = dx / 2;
+	int16_t ystep = (y0 < y1) ? 1 : -1;
+
+	// Clip the major axis range to the drawing area
+	int32_t major_min = steep ? st7789_clip.y0 : st7789_clip.x0;
+	int32_t major_max = steep ? st7789_clip.y1 : st7789_clip.x1;
+	int32_t minor_min = steep ? st7789_clip.x0 : st7789_clip.y0;
+	int32_t minor_max = steep ? st7789_clip.x1 : st7789_clip.y1;
+	if (lo < major_min) lo = major_min;
+	if (hi > major_max) hi = major_max;
+
+	// Then to the steps whose minor coordinate is inside. After k steps the
+	// minor axis has moved ceil((k * dy - half) / dx) pixels.
+	int32_t enter = (ystep > 0) ? minor_min - y0 : y0 - minor_max;
+	int32_t leave = (ystep > 0) ? minor_max - y0 : y0 - minor_min;
+	if (leave < 0) return;
+	if (dy == 0) {
+		if (enter > 0) return;
+	} else {
+		if (enter > 0) {
+			int32_t first = x0 + (int32_t)(((int64_t)(enter - 1) * dx + half) / dy) + 1;
+			if (lo < first) lo = first;
+		}
+		int32_t last = x0 + (int32_t)(((int64_t)leave * dx + half) / dy);
+		if (hi > last) hi = last;
+	}
+	if (lo > hi) return;
+
+	// Bresenham state at the first step drawn
+	int32_t k = lo - x0;
+	int32_t moved = (dx == 0) ? 0 : (int32_t)(((int64_t)k * dy - half + dx - 1) / dx);
+	int32_t err = (int32_t)(half - (int64_t)k * dy + (int64_t)moved * dx);
+	int32_t y = y0 + ystep * moved;
+	int32_t run = lo;
+
+	for (int32_t x = lo; x <= hi; x++) {
+		err -= dy;
+		if (err < 0 || x == hi) {
+			// The run ends when the minor axis steps
+			if (steep) {
+				ST7789_SpanAdd(y, run, 1, x - run + 1, color);
+			} else {
+				ST7789_SpanAdd(run, y, x - run + 1, 1, color);
+			}
+			y += ystep;
+			err += dx;
+			run = x + 1;
+		}
+	}
+}
+
+/**
+ * @brief Internal helper to send one run of an anti-aliased line
+ * @param major -> first pixel of the run along the major axis
+ * @param len -> number of pixels in the run
+ * @param minor -> upper (or left, for steep lines) pixel along the minor axis
+ * @param steep -> Whether the major axis is y
+ * @param pos -> minor coordinate of the first step (16.16), its fraction is the
+ *               coverage of the lower (or right) pixel, the other pixel gets the rest
+ * @param gradient -> minor coordinate increment per step (16.16)
+ * @param color -> color of the line
+ * @param bgcolor -> color blended under the line, NULL reads the pixels back from GRAM
+ * @param canvas -> canvas to blend into instead of the display, may be NULL
+ * @return none
+ * @note The run covers a 2 pixel wide window, or 1 pixel when no step has
+ *       coverage on the second pixel, and is clipped as a whole.
+ */
+static void ST7789_LineAARun(int32_t major, int32_t len, int32_t minor, uint8_t steep, int32_t pos, int32_t gradient,
+                             uint16_t color, const uint16_t *bgcolor, const ST7789_Canvas_t *canvas)
+{
+	int32_t span = 1;
+	for (int32_t i = 0; i < len; i++) {
+		if ((uint8_t)((pos + gradient * i) >> 8) != 0) {
+			span = 2;
+			break;
+		}
+	}
+
+	int32_t x0 = steep ? minor : major, y0 = steep ? major : minor;
+	int32_t x1 = x0 + (steep ? span : len) - 1, y1 = y0 + (steep ? len : span) - 1;
+
+	// Clip the window
+	int32_t cx0 = canvas ? 0 : st7789_clip.x0, cy0 = canvas ? 0 : st7789_clip.y0;
+	int32_t cx1 = canvas ? canvas->width - 1 : st7789_clip.x1, cy1 = canvas ? canvas->height - 1 : st7789_clip.y1;
+	if (x0 > cx0) cx0 = x0;
+	if (y0 > cy0) cy0 = y0;
+	if (x1 < cx1) cx1 = x1;
+	if (y1 < cy1) cy1 = y1;
+	if (cx0 > cx1 || cy0 > cy1) return;
+
+	if (canvas != NULL) {
+		for (int32_t y = cy0; y <= cy1; y++) {
+			for (int32_t x = cx0; x <= cx1; x++) {
+				uint8_t c = (uint8_t)((pos + gradient * (steep ? y - y0 : x - x0)) >> 8);
+				uint8_t alpha = ((steep ? x - x0 : y - y0) != 0) ? c : 255 - c;
+				uint16_t *px = &canvas->buf[(uint32_t)y * canvas->width + x];
+				*px = ST7789_BlendColor(color, *px, alpha);
+			}
+		}
+		return;
+	}
+
+	uint32_t count = (uint32_t)(cx1 - cx0 + 1) * (cy1 - cy0 + 1);
+	if (bgcolor == NULL) {
+		ST7789_ReadWindow(cx0, cy0, cx1, cy1, st7789_disp_buf, count);
+	}
+
+	uint32_t k = 0;
+	for (int32_t y = cy0; y <= cy1; y++) {
+		for (int32_t x = cx0; x <= cx1; x++, k++) {
+			uint8_t c = (uint8_t)((pos + gradient * (steep ? y - y0 : x - x0)) >> 8);
+			uint8_t alpha = ((steep ? x - x0 : y - y0) != 0) ? c : 255 - c;
+			uint16_t pixel = ST7789_BlendColor(color, (bgcolor != NULL) ? *bgcolor : st7789_disp_buf[k], alpha);
+			st7789_disp_buf[k] = (pixel >> 8) | (pixel << 8);
+		}
+	}
+
+	ST7789_Select();
+	ST7789_SetAddressWindow(cx0, cy0, cx1, cy1);
+	ST7789_WriteData((uint8_t*)st7789_disp_buf, count * 2);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Internal helper to draw an anti-aliased line (Xiaolin Wu)
+ * @param x0&y0 -> coordinate of the start point
+ * @param x1&y1 -> coordinate of the end point
+ * @param color -> color of the line
+ * @param bgcolor -> color blended under the line, NULL reads the pixels back from GRAM
+ * @param canvas -> canvas to blend into instead of the display, may be NULL
+ * @return none
+ * @note The minor coordinate is tracked in 16.16 fixed point and each step
+ *       covers two pixels, split by its fraction. Steps are grouped into runs
+ *       where the minor pixel stays the same, as in ST7789_DrawLine_Internal(),
+ *       and every run is sent as one window. End points are integer so they
+ *       get full coverage. Steps outside the clip along the major axis are skipped.
+ */
+static void ST7789_DrawLineAA_Internal(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color,
+                                       const uint16_t *bgcolor, const ST7789_Canvas_t *canvas)
+{
+	int16_t swap;
+	uint8_t steep = abs(y1 - y0) > abs(x1 - x0);
+	if (steep) {
+		swap = x0;
+		x0 = y0;
+		y0 = swap;
+
+		swap = x1;
+		x1 = y1;
+		y1 = swap;
+	}
+
+	if (x0 > x1) {
+		swap = x0;
+		x0 = x1;
+		x1 = swap;
+
+		swap = y0;
+		y0 = y1;
+		y1 = swap;
+	}
+
+	int32_t dx = x1 - x0;
+	int32_t dy = y1 - y0;
+	int32_t gradient = (dx != 0) ? (int32_t)((int64_t)dy * 65536 / dx) : 0;
+
+	// Skip the steps outside the clip along the major axis
+	int32_t lo, hi;
+	if (canvas != NULL) {
+		lo = 0;
+		hi = (steep ? canvas->height : canvas->width) - 1;
+	} else {
+		lo = steep ? st7789_clip.y0 : st7789_clip.x0;
+		hi = steep ? st7789_clip.y1 : st7789_clip.x1;
+	}
+	if (lo < x0) lo = x0;
+	if (hi > x1) hi = x1;
+
+	// Then to the steps whose pixel pair (minor, minor + 1) can touch the clip
+	int32_t mmin, mmax;
+	if (canvas != NULL) {
+		mmin = 0;
+		mmax = (steep ? canvas->width : canvas->height) - 1;
+	} else {
+		mmin = steep ? st7789_clip.x0 : st7789_clip.y0;
+		mmax = steep ? st7789_clip.x1 : st7789_clip.y1;
+	}
+	int64_t below = ((int64_t)mmin - 1 - y0) * 65536, above = ((int64_t)mmax + 1 - y0) * 65536;
+	if (gradient == 0) {
+		if (below >= 0 || above <= 0) return;
+	} else {
+		int64_t a = below / gradient, b = above / gradient;
+		int32_t first = x0 + (int32_t)((a < b) ? a : b) - 1;
+		int32_t last = x0 + (int32_t)((a < b) ? b : a) + 1;
+		if (lo < first) lo = first;
+		if (hi > last) hi = last;
+	}
+	if (lo > hi) return;
+
+	// Runs are two pixels wide, so half the buffer bounds their length
+	int32_t max_run = (canvas != NULL) ? 0x7FFF : st7789_disp_buf_size / 2;
+	int32_t run = lo, start = 0, n = 0;
+	int32_t y = (int32_t)((int64_t)y0 * 65536 + (int64_t)gradient * (lo - x0));
+
+	for (int32_t x = lo; x <= hi; x++, y += gradient) {
+		if (n > 0 && ((y >> 16) != (start >> 16) || n == max_run)) {
+			ST7789_LineAARun(run, n, start >> 16, steep, start, gradient, color, bgcolor, canvas);
+			n = 0;
+		}
+		if (n == 0) {
+			run = x;
+			start = y;
+		}
+		n++;
+	}
+	ST7789_LineAARun(run, n, start >> 16, steep, start, gradient, color, bgcolor, canvas);
+}
+
+/**
+ * @brief Internal helper to draw connected lines into the span batch
+ * @param points -> array of points
+ * @param count -> number of points
+ * @param closed -> Whether the last point is connected back to the first
+ * @param color -> color of the lines
+ * @return none
+ * @note Points shared by two segments are drawn once. Caller must flush the span batch.
+ */
+static void ST7789_DrawPolyline_Internal(const ST7789_Point_t *points, uint16_t count, uint8_t closed, uint16_t color)
+{
+	if (count == 1) {
+		ST7789_SpanAdd(points[0].x, points[0].y, 1, 1, color);
+		return;
+	}
+
+	for (uint16_t i = 0; i + 1 < count; i++) {
+		ST7789_DrawLine_Internal(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, color,
+		                         (i == 0) ? ST7789_LINE_BOTH : ST7789_LINE_END);
+	}
+
+	if (closed && count > 2) {
+		ST7789_DrawLine_Internal(points[count - 1].x, points[count - 1].y, points[0].x, points[0].y, color, 0);
 	}
+}
+
+/**
+ * @brief Draw a line with single color
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line to Draw
+ * @return none
+ */
+void ST7789_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	ST7789_Select();
+	ST7789_DrawLine_Internal(x0, y0, x1, y1, color, ST7789_LINE_BOTH);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw an anti-aliased line over a known background color
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line
+ * @param bgcolor -> background color the edge pixels are blended with
+ * @return none
+ * @note Nothing is read back, so the pixels next to the line are painted
+ *       in the blend of color and bgcolor whatever was under them.
+ */
+void ST7789_drawLineAA(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+	ST7789_DrawLineAA_Internal(x0, y0, x1, y1, color, &bgcolor, NULL);
+}
+
+/**
+ * @brief Draw an anti-aliased line blended over the current screen content
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line
+ * @return none
+ * @note Each run is read back from GRAM with RAMRD before it is blended,
+ *       see ST7789_readRect().
+ */
+void ST7789_drawLineAAReadback(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	ST7789_DrawLineAA_Internal(x0, y0, x1, y1, color, NULL, NULL);
+}
+
+/**
+ * @brief Draw an anti-aliased line blended into a canvas
+ * @param canvas -> destination canvas
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line
+ * @return none
+ */
+void ST7789_canvasDrawLineAA(const ST7789_Canvas_t *canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+	if (canvas == NULL || canvas->buf == NULL) return;
+	ST7789_DrawLineAA_Internal(x0, y0, x1, y1, color, NULL, canvas);
+}
+
+/**
+ * @brief Draw a fast horizontal line (optimized for axis-aligned lines)
+ * @param x -> starting x coordinate
+ * @param y -> y coordinate (constant for horizontal line)
+ * @param w -> width (length of line in pixels)
+ * @param color -> color of the line
+ * @return none
+ */
+void ST7789_drawFastHLine(int16_t x, int16_t y, uint16_t w, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_FillArea_Internal(x, y, w, 1, color);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a fast vertical line (optimized for axis-aligned lines)
+ * @param x -> x coordinate (constant for vertical line)
+ * @param y -> starting y coordinate
+ * @param h -> height (length of line in pixels)
+ * @param color -> color of the line
+ * @return none
+ */
+void ST7789_drawFastVLine(int16_t x, int16_t y, uint16_t h, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
 
+	ST7789_Select();
+	ST7789_FillArea_Internal(x, y, 1, h, color);
 	ST7789_UnSelect();
 }
 
@@ -686,61 +1677,125 @@ void ST7789_drawFastVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
  * @param color -> color of the Rectangle line
  * @return none
  */
-void ST7789_drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+void ST7789_drawRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
 	if (!ST7789_isInitialized()) return;
 	if (w == 0 || h == 0) return;
 
+	// Side edges leave out the corners already covered by top and bottom
 	ST7789_Select();
-	ST7789_DrawLine_Internal(x, y, x + w - 1, y, color);           // Top
-	ST7789_DrawLine_Internal(x, y, x, y + h - 1, color);           // Left
-	ST7789_DrawLine_Internal(x, y + h - 1, x + w - 1, y + h - 1, color); // Bottom
-	ST7789_DrawLine_Internal(x + w - 1, y, x + w - 1, y + h - 1, color); // Right
+	ST7789_SpanAdd(x, y, w, 1, color);                       // Top
+	if (h > 1) {
+		ST7789_SpanAdd(x, y + h - 1, w, 1, color);           // Bottom
+	}
+	if (h > 2) {
+		ST7789_SpanAdd(x, y + 1, 1, h - 2, color);           // Left
+		if (w > 1) {
+			ST7789_SpanAdd(x + w - 1, y + 1, 1, h - 2, color); // Right
+		}
+	}
+	ST7789_SpanFlush();
 	ST7789_UnSelect();
 }
 
 /**
- * @brief Draw a circle with single color
+ * @brief Internal helper to draw circle quadrants into the span batch
  * @param x0&y0 -> coordinate of circle center
  * @param r -> radius of circle
+ * @param quadrants -> bit mask of quadrants to draw (0x1 top-right, 0x2 bottom-right,
+ *                     0x4 bottom-left, 0x8 top-left)
  * @param color -> color of circle line
- * @return  none
+ * @return none
+ * @note Midpoint steps sharing a row (or a column in the steep octants) form
+ *       one span, runs are long near the axes. Circles outside the drawing
+ *       area are rejected up front. Caller must flush the span batch.
  */
-void ST7789_drawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color)
+static void ST7789_DrawCircle_Internal(int32_t x0, int32_t y0, int32_t r, uint8_t quadrants, uint16_t color)
 {
-	if (!ST7789_isInitialized()) return;
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
+	if (x0 + r < st7789_clip.x0 || x0 - r > st7789_clip.x1 ||
+	    y0 + r < st7789_clip.y0 || y0 - r > st7789_clip.y1) {
+		return;
+	}
 
-	ST7789_Select();
-	ST7789_DrawPixel_Internal(x0, y0 + r, color);
-	ST7789_DrawPixel_Internal(x0, y0 - r, color);
-	ST7789_DrawPixel_Internal(x0 + r, y0, color);
-	ST7789_DrawPixel_Internal(x0 - r, y0, color);
+	// The line can't cross a drawing area lying inside the circle
+	int32_t dx = (x0 - st7789_clip.x0 > st7789_clip.x1 - x0) ? x0 - st7789_clip.x0 : st7789_clip.x1 - x0;
+	int32_t dy = (y0 - st7789_clip.y0 > st7789_clip.y1 - y0) ? y0 - st7789_clip.y0 : st7789_clip.y1 - y0;
+	if (r > 1 && (int64_t)dx * dx + (int64_t)dy * dy < (int64_t)(r - 1) * (r - 1)) {
+		return;
+	}
 
-	while (x < y) {
-		if (f >= 0) {
-			y--;
+	if (r == 0) {
+		ST7789_SpanAdd(x0, y0, 1, 1, color);
+		return;
+	}
+
+	int32_t f = 1 - r;
+	int32_t ddF_x = 1;
+	int32_t ddF_y = -2 * r;
+	int32_t x = 0;
+	int32_t y = r;
+	int32_t run = 0;
+
+	// Each pass ends a run of midpoint steps on row y (x from run to x)
+	while (1) {
+		uint8_t last = (x >= y);
+		int32_t next_y = y;
+
+		if (!last && f >= 0) {
+			next_y--;
 			ddF_y += 2;
 			f += ddF_y;
 		}
+
+		// A last step past the diagonal mirrors the previous one, skip it
+		if ((last || next_y != y) && run <= y) {
+			// Pixels on the axes and on the diagonal belong to one octant only
+			int32_t a = run, b = x;
+			int32_t na = (a == 0) ? 1 : a;
+			int32_t vb = (b == y) ? y - 1 : b;
+
+			if (quadrants & 0x1) {
+				ST7789_SpanAdd(x0 + a, y0 - y, b - a + 1, 1, color);
+				if (vb >= na) ST7789_SpanAdd(x0 + y, y0 - vb, 1, vb - na + 1, color);
+			}
+			if (quadrants & 0x2) {
+				if (b >= na) ST7789_SpanAdd(x0 + na, y0 + y, b - na + 1, 1, color);
+				if (vb >= a) ST7789_SpanAdd(x0 + y, y0 + a, 1, vb - a + 1, color);
+			}
+			if (quadrants & 0x4) {
+				ST7789_SpanAdd(x0 - b, y0 + y, b - a + 1, 1, color);
+				if (vb >= na) ST7789_SpanAdd(x0 - y, y0 + na, 1, vb - na + 1, color);
+			}
+			if (quadrants & 0x8) {
+				if (b >= na) ST7789_SpanAdd(x0 - b, y0 - y, b - na + 1, 1, color);
+				if (vb >= a) ST7789_SpanAdd(x0 - y, y0 - vb, 1, vb - a + 1, color);
+			}
+			run = x + 1;
+		}
+
+		if (last) break;
+
+		y = next_y;
 		x++;
 		ddF_x += 2;
 		f += ddF_x;
+	}
+}
 
-		ST7789_DrawPixel_Internal(x0 + x, y0 + y, color);
-		ST7789_DrawPixel_Internal(x0 - x, y0 + y, color);
-		ST7789_DrawPixel_Internal(x0 + x, y0 - y, color);
-		ST7789_DrawPixel_Internal(x0 - x, y0 - y, color);
+/**
+ * @brief Draw a circle with single color
+ * @param x0&y0 -> coordinate of circle center
+ * @param r -> radius of circle
+ * @param color -> color of circle line
+ * @return  none
+ */
+void ST7789_drawCircle(int16_t x0, int16_t y0, uint16_t r, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
 
-		ST7789_DrawPixel_Internal(x0 + y, y0 + x, color);
-		ST7789_DrawPixel_Internal(x0 - y, y0 + x, color);
-		ST7789_DrawPixel_Internal(x0 + y, y0 - x, color);
-		ST7789_DrawPixel_Internal(x0 - y, y0 - x, color);
-	}
+	ST7789_Select();
+	ST7789_DrawCircle_Internal(x0, y0, r, 0x0F, color);
+	ST7789_SpanFlush();
 	ST7789_UnSelect();
 }
 
@@ -751,26 +1806,25 @@ void ST7789_drawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color)
  * @param data -> pointer of the Image array
  * @return none
  */
-void ST7789_drawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data)
+void ST7789_drawImage(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data)
 {
 	if (!ST7789_isInitialized()) return;
-	if ((x >= ST7789_WIDTH) || (y >= ST7789_HEIGHT))
-		return;
-	if ((x + w - 1) >= ST7789_WIDTH)
-		return;
-	if ((y + h - 1) >= ST7789_HEIGHT)
-		return;
+
+	// Only the part inside the drawing area is pushed
+	int16_t cx = x, cy = y;
+	uint16_t cw = w, ch = h;
+	if (!ST7789_ClipArea(&cx, &cy, &cw, &ch)) return;
 
 	ST7789_Select();
-	ST7789_SetAddressWindow(x, y, x + w - 1, y + h - 1);
+	ST7789_SetAddressWindow(cx, cy, cx + cw - 1, cy + ch - 1);
 
-	// Convert image data to big-endian format
-	// Note: For large images, consider using a smaller temp buffer in chunks
-	uint16_t pixel_count = w * h;
-	for (uint16_t i = 0; i < pixel_count; i++) {
-		uint16_t pixel = data[i];
-		uint8_t pixel_data[] = {pixel >> 8, pixel & 0xFF};
-		ST7789_WriteData(pixel_data, sizeof(pixel_data));
+	if (cw == w) {
+		// Full rows are contiguous in the image, stream them at once
+		ST7789_WritePixels(&data[(uint32_t)(cy - y) * w], (uint32_t)cw * ch);
+	} else {
+		for (uint16_t row = 0; row < ch; row++) {
+			ST7789_WritePixels(&data[(uint32_t)(cy - y + row) * w + (cx - x)], cw);
+		}
 	}
 
 	ST7789_UnSelect();
@@ -790,15 +1844,850 @@ void ST7789_invertColors(uint8_t invert)
 }
 
 /**
- * @brief Write a char using GFXfont format
- * @param  x&y -> cursor position (baseline)
- * @param ch -> char to write
- * @param font -> pointer to GFXfont structure
- * @param color -> color of the char
- * @param bgcolor -> background color of the char
+ * @brief Restrict drawing to a rectangle
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @return none
+ * @note Applies to all drawing functions until ST7789_resetClipRect(),
+ *       in the coordinates of the current rotation. An empty rectangle
+ *       suppresses drawing.
+ */
+void ST7789_setClipRect(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	if (!ST7789_isInitialized()) return;
+
+	int32_t x1 = (int32_t)x + w - 1, y1 = (int32_t)y + h - 1;
+
+	st7789_user_clip.rect.x0 = x;
+	st7789_user_clip.rect.y0 = y;
+	st7789_user_clip.rect.x1 = (x1 > INT16_MAX) ? INT16_MAX : x1;
+	st7789_user_clip.rect.y1 = (y1 > INT16_MAX) ? INT16_MAX : y1;
+	st7789_user_clip.enabled = 1;
+	ST7789_UpdateClip();
+}
+
+/**
+ * @brief Remove the clip rectangle set by ST7789_setClipRect()
+ * @return none
+ */
+void ST7789_resetClipRect(void)
+{
+	if (!ST7789_isInitialized()) return;
+
+	st7789_user_clip.enabled = 0;
+	ST7789_UpdateClip();
+}
+
+/**
+ * @brief Read a pixel back from GRAM
+ * @param x&y -> coordinate to read
+ * @return Pixel color (RGB565), 0 if outside the screen
+ */
+uint16_t ST7789_readPixel(uint16_t x, uint16_t y)
+{
+	uint16_t color = 0;
+
+	if (!ST7789_isInitialized()) return 0;
+	if ((x >= ST7789_WIDTH) || (y >= ST7789_HEIGHT)) return 0;
+
+	ST7789_ReadWindow(x, y, x, y, &color, 1);
+	return color;
+}
+
+/**
+ * @brief Read a rectangle back from GRAM
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @param dest -> pointer to store w * h pixels (RGB565, MCU byte order),
+ *                NULL to read into st7789_disp_buf
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM if the rectangle is outside
+ *         the screen or doesn't fit in st7789_disp_buf
+ * @note Pixels read back can be sent again with ST7789_drawImage()
+ */
+ST7789_Status_t ST7789_readRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *dest)
+{
+	if (!ST7789_isInitialized()) return ST7789_ERR_INVALID_PARAM;
+	if (w == 0 || h == 0) return ST7789_ERR_INVALID_PARAM;
+	if (((uint32_t)x + w > ST7789_WIDTH) || ((uint32_t)y + h > ST7789_HEIGHT)) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	if (dest == NULL) {
+		if ((uint32_t)w * h > st7789_disp_buf_size) {
+			return ST7789_ERR_INVALID_PARAM;
+		}
+		dest = st7789_disp_buf;
+	}
+
+	ST7789_ReadWindow(x, y, x + w - 1, y + h - 1, dest, (uint32_t)w * h);
+	return ST7789_OK;
+}
+
+/**
+ * @brief Get the row stride of an alpha channel in bytes
+ * @param w -> image width
+ * @param format -> alpha channel format
+ * @return bytes per alpha row, 0 without an alpha channel
+ */
+static uint32_t ST7789_AlphaStride(uint16_t w, ST7789_AlphaFormat_t format)
+{
+	if (format == ST7789_ALPHA_A8) return w;
+	if (format == ST7789_ALPHA_A4) return ((uint32_t)w + 1) / 2;
+	return 0;
+}
+
+/**
+ * @brief Draw an image blended over the screen
+ * @param x&y -> top-left corner of the image
+ * @param w&h -> width & height of the image
+ * @param data -> w * h pixels (RGB565, MCU byte order)
+ * @param alpha -> alpha channel in the given format, may be NULL for ST7789_ALPHA_CONST
+ * @param format -> alpha channel format
+ * @param opacity -> constant opacity applied on top of the alpha channel (0-255)
+ * @return none
+ * @note The pixels under the image are read back from GRAM, blended in
+ *       st7789_disp_buf and sent again, one buffer-sized tile at a time.
+ */
+void ST7789_drawImageAlpha(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data,
+                           const uint8_t *alpha, ST7789_AlphaFormat_t format, uint8_t opacity)
+{
+	if (!ST7789_isInitialized()) return;
+	if (data == NULL || opacity == 0) return;
+	if (format != ST7789_ALPHA_CONST && alpha == NULL) return;
+
+	if (format == ST7789_ALPHA_CONST && opacity == 255) {
+		ST7789_drawImage(x, y, w, h, data);
+		return;
+	}
+
+	int16_t cx = x, cy = y;
+	uint16_t cw = w, ch = h;
+	if (!ST7789_ClipArea(&cx, &cy, &cw, &ch)) return;
+
+	uint32_t stride = ST7789_AlphaStride(w, format);
+
+	for (uint16_t tx = 0; tx < cw; tx += st7789_disp_buf_size) {
+		uint16_t tile_w = ((cw - tx) > st7789_disp_buf_size) ? st7789_disp_buf_size : (cw - tx);
+		uint16_t rows = st7789_disp_buf_size / tile_w;
+		uint16_t col = cx - x + tx;
+
+		for (uint16_t ty = 0; ty < ch; ty += rows) {
+			uint16_t tile_h = ((ch - ty) > rows) ? rows : (ch - ty);
+			uint32_t count = (uint32_t)tile_w * tile_h;
+
+			ST7789_ReadWindow(cx + tx, cy + ty, cx + tx + tile_w - 1, cy + ty + tile_h - 1, st7789_disp_buf, count);
+
+			for (uint16_t row = 0; row < tile_h; row++) {
+				uint32_t src_row = (uint32_t)(cy - y + ty + row);
+				ST7789_BlendRow(&st7789_disp_buf[row * tile_w], &data[src_row * w + col],
+				                (alpha != NULL) ? &alpha[src_row * stride] : NULL, col, tile_w, format, opacity);
+			}
+
+			// Convert to big-endian in place
+			for (uint32_t i = 0; i < count; i++) {
+				uint16_t pixel = st7789_disp_buf[i];
+				st7789_disp_buf[i] = (pixel >> 8) | (pixel << 8);
+			}
+
+			ST7789_Select();
+			ST7789_SetAddressWindow(cx + tx, cy + ty, cx + tx + tile_w - 1, cy + ty + tile_h - 1);
+			ST7789_WriteData((uint8_t*)st7789_disp_buf, count * 2);
+			ST7789_UnSelect();
+		}
+	}
+}
+
+/**
+ * @brief Draw an image blended over a canvas
+ * @param canvas -> destination canvas
+ * @param x&y -> top-left corner of the image on the canvas
+ * @param w&h -> width & height of the image
+ * @param data -> w * h pixels (RGB565, MCU byte order)
+ * @param alpha -> alpha channel in the given format, may be NULL for ST7789_ALPHA_CONST
+ * @param format -> alpha channel format
+ * @param opacity -> constant opacity applied on top of the alpha channel (0-255)
+ * @return none
+ */
+void ST7789_canvasDrawImageAlpha(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                                 const uint16_t *data, const uint8_t *alpha, ST7789_AlphaFormat_t format, uint8_t opacity)
+{
+	if (canvas == NULL || canvas->buf == NULL || data == NULL || opacity == 0) return;
+	if (format != ST7789_ALPHA_CONST && alpha == NULL) return;
+
+	// Clip to the canvas
+	int32_t x0 = (x < 0) ? 0 : x, y0 = (y < 0) ? 0 : y;
+	int32_t x1 = ((int32_t)x + w > canvas->width) ? canvas->width : (int32_t)x + w;
+	int32_t y1 = ((int32_t)y + h > canvas->height) ? canvas->height : (int32_t)y + h;
+	if (x0 >= x1 || y0 >= y1) return;
+
+	uint32_t stride = ST7789_AlphaStride(w, format);
+	uint16_t col = x0 - x;
+
+	for (int32_t cy = y0; cy < y1; cy++) {
+		uint32_t src_row = (uint32_t)(cy - y);
+		ST7789_BlendRow(&canvas->buf[(uint32_t)cy * canvas->width + x0], &data[src_row * w + col],
+		                (alpha != NULL) ? &alpha[src_row * stride] : NULL, col, x1 - x0, format, opacity);
+	}
+}
+
+/**
+ * @brief Draw an image, leaving pixels of the key color untouched
+ * @param x&y -> top-left corner of the image
+ * @param w&h -> width & height of the image
+ * @param data -> w * h pixels (RGB565, MCU byte order)
+ * @param key -> transparent color
+ * @return none
+ * @note Each row is split into opaque runs sent as their own window. Rows made of
+ *       the same single run are merged into one window, and rows with more than
+ *       ST7789_KEY_MAX_RUNS runs are read back and rewritten in one window.
+ */
+void ST7789_drawImageKeyed(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data, uint16_t key)
+{
+	if (!ST7789_isInitialized()) return;
+	if (data == NULL) return;
+
+	int16_t cx = x, cy = y;
+	uint16_t cw = w, ch = h;
+	if (!ST7789_ClipArea(&cx, &cy, &cw, &ch)) return;
+
+	// Pending window of identical single-run rows
+	const uint16_t *pend = NULL;
+	uint16_t pend_x = 0, pend_y = 0, pend_len = 0, pend_rows = 0;
+
+	for (uint16_t row = 0; row <= ch; row++) {
+		const uint16_t *line = NULL;
+		uint16_t runs = 0, first = 0, last = 0;
+
+		// One extra pass after the last row flushes the pending window
+		if (row < ch) {
+			line = &data[(uint32_t)(cy - y + row) * w + (cx - x)];
+			for (uint16_t i = 0; i < cw; i++) {
+				if (line[i] == key) continue;
+				if (i == 0 || line[i - 1] == key) {
+					if (runs++ == 0) first = i;
+				}
+				last = i;
+			}
+
+			if (runs == 1 && pend_rows > 0 && pend_x == cx + first && pend_len == last - first + 1) {
+				pend_rows++;
+				continue;
+			}
+		}
+
+		if (pend_rows > 0) {
+			ST7789_Select();
+			ST7789_SetAddressWindow(pend_x, pend_y, pend_x + pend_len - 1, pend_y + pend_rows - 1);
+			ST7789_WriteRows(pend, w, pend_len, pend_rows);
+			ST7789_UnSelect();
+			pend_rows = 0;
+		}
+
+		if (runs == 0) continue;
+
+		uint16_t span = last - first + 1;
+
+		if (runs == 1) {
+			pend = &line[first];
+			pend_x = cx + first;
+			pend_y = cy + row;
+			pend_len = span;
+			pend_rows = 1;
+		} else if (runs > ST7789_KEY_MAX_RUNS && span <= st7789_disp_buf_size) {
+			// Too many window setups, rewrite the whole span over what is on screen
+			ST7789_ReadWindow(cx + first, cy + row, cx + last, cy + row, st7789_disp_buf, span);
+			for (uint16_t i = 0; i < span; i++) {
+				uint16_t pixel = (line[first + i] != key) ? line[first + i] : st7789_disp_buf[i];
+				st7789_disp_buf[i] = (pixel >> 8) | (pixel << 8);
+			}
+
+			ST7789_Select();
+			ST7789_SetAddressWindow(cx + first, cy + row, cx + last, cy + row);
+			ST7789_WriteData((uint8_t*)st7789_disp_buf, span * 2);
+			ST7789_UnSelect();
+		} else {
+			for (uint16_t i = first; i <= last; i++) {
+				if (line[i] == key) continue;
+
+				uint16_t end = i;
+				while (end < last && line[end + 1] != key) end++;
+
+				ST7789_Select();
+				ST7789_SetAddressWindow(cx + i, cy + row, cx + end, cy + row);
+				ST7789_WritePixels(&line[i], end - i + 1);
+				ST7789_UnSelect();
+				i = end;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Draw an image on a canvas, skipping pixels of the key color
+ * @param canvas -> destination canvas
+ * @param x&y -> top-left corner of the image on the canvas
+ * @param w&h -> width & height of the image
+ * @param data -> w * h pixels (RGB565, MCU byte order)
+ * @param key -> transparent color
+ * @return none
+ */
+void ST7789_canvasDrawImageKeyed(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                                 const uint16_t *data, uint16_t key)
+{
+	if (canvas == NULL || canvas->buf == NULL || data == NULL) return;
+
+	// Clip to the canvas
+	int32_t x0 = (x < 0) ? 0 : x, y0 = (y < 0) ? 0 : y;
+	int32_t x1 = ((int32_t)x + w > canvas->width) ? canvas->width : (int32_t)x + w;
+	int32_t y1 = ((int32_t)y + h > canvas->height) ? canvas->height : (int32_t)y + h;
+	if (x0 >= x1 || y0 >= y1) return;
+
+	for (int32_t cy = y0; cy < y1; cy++) {
+		const uint16_t *src = &data[(uint32_t)(cy - y) * w + (x0 - x)];
+		uint16_t *dst = &canvas->buf[(uint32_t)cy * canvas->width + x0];
+
+		for (int32_t n = x1 - x0; n > 0; n--, src++, dst++) {
+			if (*src != key) *dst = *src;
+		}
+	}
+}
+
+/* Span left for the flood fill: row y + dy is scanned under [x0, x1] */
+typedef struct {
+	uint16_t x0;
+	uint16_t x1;
+	uint16_t y;
+	int16_t dy;
+} ST7789_FillSpan_t;
+
+/* Flood fill span stack */
+typedef struct {
+	ST7789_FillSpan_t *spans;   // ST7789_FLOOD_STACK_SPANS entries
+	uint16_t top;
+	uint16_t height;            // Rows of the canvas
+} ST7789_FillStack_t;
+
+static ST7789_FillSpan_t st7789_fill_spans[ST7789_FLOOD_STACK_SPANS];
+
+/**
+ * @brief Internal helper to push a span for the flood fill
+ * @param stack -> span stack
+ * @param x0&x1 -> columns of the span, inclusive
+ * @param y -> row of the span
+ * @param dy -> direction of the row to scan next (+1 or -1)
+ * @return 1 on success, 0 if the stack is full
+ * @note Spans whose next row is outside the canvas are dropped
+ */
+static uint8_t ST7789_FillPush(ST7789_FillStack_t *stack, int32_t x0, int32_t x1, int32_t y, int32_t dy)
+{
+	if (y + dy < 0 || y + dy >= stack->height) return 1;
+
+	if (stack->top == ST7789_FLOOD_STACK_SPANS) return 0;
+
+	ST7789_FillSpan_t *span = &stack->spans[stack->top++];
+	span->x0 = x0;
+	span->x1 = x1;
+	span->y = y;
+	span->dy = dy;
+	return 1;
+}
+
+/**
+ * @brief Internal helper to pick the color the flood fill marks dropped runs with
+ * @param canvas -> canvas being filled
+ * @param old -> color of the region
+ * @param color -> new color of the region
+ * @param marker -> pointer to store the marker color
+ * @return 1 if a color missing from the canvas was found, 0 otherwise
+ * @note Candidates are the new color with scattered bits flipped, so runs of
+ *       nearby colors (gradients, palettes) rarely cover them all. 8 are
+ *       checked per pass over the canvas, ST7789_FLOOD_MARKER_PASSES at most.
+ */
+static uint8_t ST7789_FillMarker(const ST7789_Canvas_t *canvas, uint16_t old, uint16_t color, uint16_t *marker)
+{
+	uint32_t count = (uint32_t)canvas->width * canvas->height;
+
+	for (uint16_t pass = 0; pass < ST7789_FLOOD_MARKER_PASSES; pass++) {
+		uint16_t candidates[8];
+		uint8_t seen = 0;
+
+		for (uint8_t c = 0; c < 8; c++) {
+			candidates[c] = color ^ (uint16_t)((pass * 8 + c + 1) * 0x9E37);
+			if (candidates[c] == old) seen |= 1 << c;
+		}
+
+		for (uint32_t i = 0; i < count && seen != 0xFF; i++) {
+			uint16_t pixel = canvas->buf[i];
+			for (uint8_t c = 0; c < 8; c++) {
+				if (pixel == candidates[c]) seen |= 1 << c;
+			}
+		}
+
+		for (uint8_t c = 0; c < 8; c++) {
+			if (!(seen & (1 << c))) {
+				*marker = candidates[c];
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Fill the 4-connected region of a canvas around a seed pixel
+ * @param canvas -> canvas to fill
+ * @param x&y -> seed pixel
+ * @param color -> new color of the region
+ * @param damage -> pointer to store the bounding box of changed pixels (may be NULL),
+ *                  w and h are 0 when nothing changed
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM on bad arguments,
+ *         ST7789_ERR_OVERFLOW when the span stack overflowed and no marker
+ *         color was free (the region is then only partly filled, damage still
+ *         covers what changed)
+ * @note Scanline fill without recursion: each popped span fills whole runs of
+ *       the seed color on the next row and pushes them onward, plus the parts
+ *       sticking out past their parent span back the other way. Runs that
+ *       don't fit the static stack (ST7789_FLOOD_STACK_SPANS) are recolored
+ *       with a color missing from the canvas and the fill goes on with it.
+ *       Once the stack drains, the damage is scanned for marked runs next to
+ *       unfilled pixels to seed it again, and the marker is finally replaced.
+ *       Fills that fit the stack touch only the region.
+ *       Nothing is sent to the display, pass damage to ST7789_canvasFlush().
+ */
+ST7789_Status_t ST7789_canvasFloodFill(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t color,
+                                       ST7789_Rect_t *damage)
+{
+	if (damage != NULL) {
+		damage->x = 0;
+		damage->y = 0;
+		damage->w = 0;
+		damage->h = 0;
+	}
+	if (canvas == NULL || canvas->buf == NULL) return ST7789_ERR_INVALID_PARAM;
+	if (x < 0 || y < 0 || x >= canvas->width || y >= canvas->height) return ST7789_OK;
+
+	uint16_t *buf = canvas->buf;
+	int32_t width = canvas->width;
+	uint16_t old = buf[(uint32_t)y * width + x];
+	if (old == color) return ST7789_OK;
+
+	ST7789_FillStack_t stack = {st7789_fill_spans, 0, canvas->height};
+	ST7789_Status_t status = ST7789_OK;
+	uint16_t mark = color;
+	uint8_t overflow = 0;
+	int32_t dx0 = x, dy0 = y, dx1 = x, dy1 = y;
+
+	// The seed row is scanned first, as if reached from the row below
+	ST7789_FillPush(&stack, x, x, y, 1);
+	ST7789_FillPush(&stack, x, x, y + 1, -1);
+
+	while (stack.top > 0 && status == ST7789_OK) {
+		while (stack.top > 0 && status == ST7789_OK) {
+			ST7789_FillSpan_t span = stack.spans[--stack.top];
+			int32_t row_y = span.y + span.dy;
+			uint16_t *row = &buf[(uint32_t)row_y * width];
+			int32_t cx = span.x0;
+
+			while (cx <= span.x1) {
+				while (cx <= span.x1 && row[cx] != old) cx++;
+				if (cx > span.x1) break;
+
+				// Run through cx, only the first one can reach left of the span
+				int32_t l = cx, r = cx;
+				while (l > 0 && row[l - 1] == old) l--;
+				while (r + 1 < width && row[r + 1] == old) r++;
+				for (int32_t i = l; i <= r; i++) {
+					row[i] = mark;
+				}
+
+				if (l < dx0) dx0 = l;
+				if (r > dx1) dx1 = r;
+				if (row_y < dy0) dy0 = row_y;
+				if (row_y > dy1) dy1 = row_y;
+
+				if (!ST7789_FillPush(&stack, l, r, row_y, span.dy) ||
+				    (l < span.x0 && !ST7789_FillPush(&stack, l, span.x0 - 1, row_y, -span.dy)) ||
+				    (r > span.x1 && !ST7789_FillPush(&stack, span.x1 + 1, r, row_y, -span.dy))) {
+					// Dropped run: mark it so the rescan finds it
+					if (mark == color && !ST7789_FillMarker(canvas, old, color, &mark)) {
+						status = ST7789_ERR_OVERFLOW;
+						break;
+					}
+					for (int32_t i = l; i <= r; i++) {
+						row[i] = mark;
+					}
+					overflow = 1;
+				}
+				cx = r + 2;
+			}
+		}
+
+		if (!overflow || status != ST7789_OK) break;
+
+		// Seed again from marked runs with unfilled region pixels above or below
+		overflow = 0;
+		for (int32_t row_y = dy0; row_y <= dy1 && !overflow; row_y++) {
+			uint16_t *row = &buf[(uint32_t)row_y * width];
+
+			for (int32_t cx = dx0; cx <= dx1 && !overflow; cx++) {
+				if (row[cx] != mark) continue;
+
+				int32_t l = cx;
+				while (cx + 1 <= dx1 && row[cx + 1] == mark) cx++;
+
+				for (int32_t dy = -1; dy <= 1; dy += 2) {
+					if (row_y + dy < 0 || row_y + dy >= canvas->height) continue;
+
+					const uint16_t *next = &buf[(uint32_t)(row_y + dy) * width];
+					int32_t i = l;
+					while (i <= cx && next[i] != old) i++;
+					if (i <= cx && !ST7789_FillPush(&stack, l, cx, row_y, dy)) overflow = 1;
+				}
+			}
+		}
+	}
+
+	if (mark != color) {
+		for (int32_t row_y = dy0; row_y <= dy1; row_y++) {
+			uint16_t *row = &buf[(uint32_t)row_y * width];
+			for (int32_t i = dx0; i <= dx1; i++) {
+				if (row[i] == mark) row[i] = color;
+			}
+		}
+	}
+
+	if (damage != NULL) {
+		damage->x = dx0;
+		damage->y = dy0;
+		damage->w = dx1 - dx0 + 1;
+		damage->h = dy1 - dy0 + 1;
+	}
+	return status;
+}
+
+/**
+ * @brief Copy a rectangle of a canvas to another place on the same canvas
+ * @param canvas -> canvas to copy on
+ * @param x&y -> top-left corner of the source
+ * @param w&h -> width & height of the source
+ * @param dst_x&dst_y -> top-left corner of the destination
+ * @param damage -> pointer to store the area that changed (may be NULL),
+ *                  w and h are 0 when nothing was copied
+ * @return none
+ * @note Source and destination may overlap, rows are moved with memmove in
+ *       the order that reads each row before it is overwritten, and whole
+ *       rows in place are moved as one block. Pixels uncovered by the move
+ *       keep their old content. Nothing is sent to the display, pass damage
+ *       to ST7789_canvasFlush().
+ */
+void ST7789_canvasCopyRect(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                           int16_t dst_x, int16_t dst_y, ST7789_Rect_t *damage)
+{
+	if (damage != NULL) {
+		damage->x = 0;
+		damage->y = 0;
+		damage->w = 0;
+		damage->h = 0;
+	}
+	if (canvas == NULL || canvas->buf == NULL) return;
+
+	int32_t dx = (int32_t)dst_x - x, dy = (int32_t)dst_y - y;
+	int32_t width = canvas->width, height = canvas->height;
+
+	// Clip the source so both it and the destination stay on the canvas
+	int32_t x0 = x, y0 = y;
+	int32_t x1 = (int32_t)x + w, y1 = (int32_t)y + h;	// exclusive
+	if (x0 < 0) x0 = 0;
+	if (x0 < -dx) x0 = -dx;
+	if (y0 < 0) y0 = 0;
+	if (y0 < -dy) y0 = -dy;
+	if (x1 > width) x1 = width;
+	if (x1 > width - dx) x1 = width - dx;
+	if (y1 > height) y1 = height;
+	if (y1 > height - dy) y1 = height - dy;
+	if (x0 >= x1 || y0 >= y1) return;
+
+	uint16_t *buf = canvas->buf;
+	uint32_t rows = y1 - y0;
+	uint32_t bytes = (uint32_t)(x1 - x0) * sizeof(uint16_t);
+
+	if (dx == 0 && x0 == 0 && x1 == width) {
+		memmove(&buf[(uint32_t)(y0 + dy) * width], &buf[(uint32_t)y0 * width], rows * bytes);
+	} else if (dy > 0) {
+		for (int32_t row = y1 - 1; row >= y0; row--) {
+			memmove(&buf[(uint32_t)(row + dy) * width + x0 + dx], &buf[(uint32_t)row * width + x0], bytes);
+		}
+	} else {
+		for (int32_t row = y0; row < y1; row++) {
+			memmove(&buf[(uint32_t)(row + dy) * width + x0 + dx], &buf[(uint32_t)row * width + x0], bytes);
+		}
+	}
+
+	if (damage != NULL) {
+		damage->x = x0 + dx;
+		damage->y = y0 + dy;
+		damage->w = x1 - x0;
+		damage->h = rows;
+	}
+}
+
+/**
+ * @brief Send a region of a canvas to the screen
+ * @param canvas -> canvas to send
+ * @param x&y -> position of the canvas top-left corner on the screen
+ * @param rect -> region of the canvas to send, NULL for the whole canvas
+ * @return none
+ * @note Only the rows and columns of the region go out, converted to
+ *       big-endian through st7789_disp_buf one buffer-sized tile at a time.
+ *       Damage from ST7789_canvasFloodFill() and ST7789_canvasCopyRect() can be
+ *       passed as rect directly, or to ST7789_compositorInvalidateLayer() when
+ *       the canvas is a compositor layer.
+ */
+void ST7789_canvasFlush(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, const ST7789_Rect_t *rect)
+{
+	if (!ST7789_isInitialized()) return;
+	if (canvas == NULL || canvas->buf == NULL) return;
+
+	// Region on the canvas
+	int32_t x0 = 0, y0 = 0, x1 = canvas->width, y1 = canvas->height;	// exclusive
+	if (rect != NULL) {
+		if (rect->x > x0) x0 = rect->x;
+		if (rect->y > y0) y0 = rect->y;
+		if ((int32_t)rect->x + rect->w < x1) x1 = (int32_t)rect->x + rect->w;
+		if ((int32_t)rect->y + rect->h < y1) y1 = (int32_t)rect->y + rect->h;
+	}
+
+	// On the screen, clipped
+	x0 += x;
+	x1 += x;
+	y0 += y;
+	y1 += y;
+	if (x0 < st7789_clip.x0) x0 = st7789_clip.x0;
+	if (y0 < st7789_clip.y0) y0 = st7789_clip.y0;
+	if (x1 > st7789_clip.x1 + 1) x1 = st7789_clip.x1 + 1;
+	if (y1 > st7789_clip.y1 + 1) y1 = st7789_clip.y1 + 1;
+	if (x0 >= x1 || y0 >= y1) return;
+
+	uint16_t cw = x1 - x0, ch = y1 - y0;
+
+	for (uint16_t tx = 0; tx < cw; tx += st7789_disp_buf_size) {
+		uint16_t tile_w = ((cw - tx) > st7789_disp_buf_size) ? st7789_disp_buf_size : (cw - tx);
+		uint16_t rows = st7789_disp_buf_size / tile_w;
+
+		for (uint16_t ty = 0; ty < ch; ty += rows) {
+			uint16_t tile_h = ((ch - ty) > rows) ? rows : (ch - ty);
+			uint32_t count = (uint32_t)tile_w * tile_h;
+
+			// Convert to big-endian while copying
+			for (uint16_t row = 0; row < tile_h; row++) {
+				const uint16_t *src = &canvas->buf[(uint32_t)(y0 - y + ty + row) * canvas->width + (x0 - x + tx)];
+				uint16_t *dst = &st7789_disp_buf[row * tile_w];
+
+				for (uint16_t i = 0; i < tile_w; i++) {
+					dst[i] = (src[i] >> 8) | (src[i] << 8);
+				}
+			}
+
+			ST7789_Select();
+			ST7789_SetAddressWindow(x0 + tx, y0 + ty, x0 + tx + tile_w - 1, y0 + ty + tile_h - 1);
+			ST7789_WriteData((uint8_t*)st7789_disp_buf, count * 2);
+			ST7789_UnSelect();
+		}
+	}
+}
+
+/* Pixels for every 4-bit pattern of a 1bpp bitmap, in wire byte order */
+typedef struct {
+	uint16_t px[16][4];
+} ST7789_BitLUT_t;
+
+/**
+ * @brief Build the nibble lookup table for a color pair
+ * @param lut -> table to fill
+ * @param color -> color of set bits
+ * @param bgcolor -> color of clear bits
+ * @return none
+ */
+static void ST7789_BitLUTInit(ST7789_BitLUT_t *lut, uint16_t color, uint16_t bgcolor)
+{
+	uint16_t fg = (color >> 8) | (color << 8);
+	uint16_t bg = (bgcolor >> 8) | (bgcolor << 8);
+
+	for (uint8_t nibble = 0; nibble < 16; nibble++) {
+		for (uint8_t i = 0; i < 4; i++) {
+			lut->px[nibble][i] = (nibble & (0x08 >> i)) ? fg : bg;
+		}
+	}
+}
+
+/**
+ * @brief Expand packed bits to pixels through a nibble lookup table
+ * @param lut -> table for the color pair
+ * @param bits -> packed bitmap, MSB first
+ * @param bit -> index of the first bit
+ * @param n -> number of pixels
+ * @param dst -> pixels out (wire byte order)
+ * @return none
+ * @note Bits up to a nibble boundary are expanded one by one, then four at a time
+ */
+static void ST7789_ExpandBits(const ST7789_BitLUT_t *lut, const uint8_t *bits, uint32_t bit, uint16_t n, uint16_t *dst)
+{
+	for (; n > 0 && (bit & 3) != 0; n--, bit++) {
+		*dst++ = lut->px[((bits[bit >> 3] >> (7 - (bit & 7))) & 1) ? 15 : 0][0];
+	}
+	for (; n >= 4; n -= 4, bit += 4) {
+		const uint16_t *px = lut->px[(bits[bit >> 3] >> (4 - (bit & 4))) & 0x0F];
+		dst[0] = px[0];
+		dst[1] = px[1];
+		dst[2] = px[2];
+		dst[3] = px[3];
+		dst += 4;
+	}
+	for (; n > 0; n--, bit++) {
+		*dst++ = lut->px[((bits[bit >> 3] >> (7 - (bit & 7))) & 1) ? 15 : 0][0];
+	}
+}
+
+/**
+ * @brief Internal helper to draw a 1bpp bitmap with both colors
+ * @param x&y -> top-left corner of the bitmap
+ * @param w&h -> width & height of the bitmap
+ * @param bits -> packed bitmap, MSB first
+ * @param first -> index of the bit of the top-left pixel
+ * @param stride -> bits between the starts of two rows
+ * @param color -> color of set bits
+ * @param bgcolor -> color of clear bits
+ * @return none
+ * @note The clipped bitmap is one window. Rows are expanded into
+ *       st7789_disp_buf and sent each time it fills up.
+ */
+static void ST7789_DrawBits_Internal(int32_t x, int32_t y, uint16_t w, uint16_t h, const uint8_t *bits,
+                                     uint32_t first, uint32_t stride, uint16_t color, uint16_t bgcolor)
+{
+	int32_t x0 = (x < st7789_clip.x0) ? st7789_clip.x0 : x;
+	int32_t y0 = (y < st7789_clip.y0) ? st7789_clip.y0 : y;
+	int32_t x1 = (x + w - 1 > st7789_clip.x1) ? st7789_clip.x1 : x + w - 1;
+	int32_t y1 = (y + h - 1 > st7789_clip.y1) ? st7789_clip.y1 : y + h - 1;
+	if (w == 0 || h == 0 || x0 > x1 || y0 > y1) return;
+
+	ST7789_BitLUT_t lut;
+	ST7789_BitLUTInit(&lut, color, bgcolor);
+
+	uint16_t fill = 0;
+
+	ST7789_Select();
+	ST7789_SetAddressWindow(x0, y0, x1, y1);
+	for (int32_t row = y0; row <= y1; row++) {
+		uint32_t bit = first + (uint32_t)(row - y) * stride + (x0 - x);
+
+		for (uint16_t left = x1 - x0 + 1; left > 0; ) {
+			uint16_t chunk = (left > st7789_disp_buf_size - fill) ? st7789_disp_buf_size - fill : left;
+
+			ST7789_ExpandBits(&lut, bits, bit, chunk, &st7789_disp_buf[fill]);
+			fill += chunk;
+			bit += chunk;
+			left -= chunk;
+
+			if (fill == st7789_disp_buf_size) {
+				ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+				fill = 0;
+			}
+		}
+	}
+	if (fill > 0) {
+		ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a 1bpp bitmap with a foreground and a background color
+ * @param x&y -> top-left corner of the bitmap
+ * @param w&h -> width & height of the bitmap
+ * @param bitmap -> packed bits, MSB first, each row padded to a whole byte
+ * @param color -> color of set bits
+ * @param bgcolor -> color of clear bits
+ * @return none
+ * @note Bits are expanded four at a time through a lookup table built for
+ *       the color pair, the bitmap is sent as one window
+ */
+void ST7789_drawBitmap1bpp(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *bitmap,
+                           uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+	if (bitmap == NULL) return;
+
+	ST7789_DrawBits_Internal(x, y, w, h, bitmap, 0, ((uint32_t)w + 7) / 8 * 8, color, bgcolor);
+}
+
+/**
+ * @brief Draw the set bits of a 1bpp bitmap, leaving the others untouched
+ * @param x&y -> top-left corner of the bitmap
+ * @param w&h -> width & height of the bitmap
+ * @param bitmap -> packed bits, MSB first, each row padded to a whole byte
+ * @param color -> color of set bits
+ * @return none
+ * @note Runs of set bits become spans, whole 0x00 and 0xFF bytes are
+ *       skipped over in one step. Runs repeated on the next rows merge
+ *       into one window.
+ */
+void ST7789_drawBitmap1bppTransparent(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *bitmap,
+                                      uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (bitmap == NULL) return;
+
+	uint32_t stride = ((uint32_t)w + 7) / 8;
+	uint16_t rows = h;
+
+	// Rows outside the clip are not scanned
+	if ((int32_t)y + rows - 1 > st7789_clip.y1) {
+		rows = (y > st7789_clip.y1) ? 0 : st7789_clip.y1 - y + 1;
+	}
+
+	uint16_t row = ((int32_t)y < st7789_clip.y0) ? st7789_clip.y0 - y : 0;
+
+	ST7789_Select();
+	for (; row < rows; row++) {
+		const uint8_t *line = &bitmap[row * stride];
+		int32_t run = -1;
+
+		for (uint16_t col = 0; col < w; ) {
+			uint8_t byte = line[col >> 3];
+
+			// Whole bytes that don't end or start a run
+			if ((col & 7) == 0 && col + 8 <= w && byte == ((run >= 0) ? 0xFF : 0x00)) {
+				col += 8;
+				continue;
+			}
+
+			uint8_t set = (byte >> (7 - (col & 7))) & 1;
+			if (set && run < 0) {
+				run = col;
+			} else if (!set && run >= 0) {
+				ST7789_SpanAdd((int32_t)x + run, (int32_t)y + row, col - run, 1, color);
+				run = -1;
+			}
+			col++;
+		}
+		if (run >= 0) {
+			ST7789_SpanAdd((int32_t)x + run, (int32_t)y + row, w - run, 1, color);
+		}
+	}
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Write a char using GFXfont format
+ * @param  x&y -> cursor position (baseline)
+ * @param ch -> char to write
+ * @param font -> pointer to GFXfont structure
+ * @param color -> color of the char
+ * @param bgcolor -> background color of the char
  * @return  none
  */
-void ST7789_drawChar(uint16_t x, uint16_t y, char ch, const GFXfont *font, uint16_t color, uint16_t bgcolor)
+void ST7789_drawChar(int16_t x, int16_t y, char ch, const GFXfont *font, uint16_t color, uint16_t bgcolor)
 {
 	if (!ST7789_isInitialized()) return;
 
@@ -822,408 +2711,3122 @@ void ST7789_drawChar(uint16_t x, uint16_t y, char ch, const GFXfont *font, uint1
 	int16_t draw_x = x + xo;
 	int16_t draw_y = y + yo;
 
-	// Bounds check - skip if completely outside screen
-	if ((draw_x >= ST7789_WIDTH) || (draw_y >= ST7789_HEIGHT) ||
-	    ((draw_x + w) <= 0) || ((draw_y + h) <= 0)) {
+	// Bounds check - skip empty glyphs and glyphs completely outside the drawing area
+	if ((w == 0) || (h == 0) ||
+	    (draw_x > st7789_clip.x1) || (draw_y > st7789_clip.y1) ||
+	    ((draw_x + w - 1) < st7789_clip.x0) || ((draw_y + h - 1) < st7789_clip.y0)) {
 		return;
 	}
 
-	// Calculate clipped drawing region
-	int16_t x_start = (draw_x < 0) ? 0 : draw_x;
-	int16_t y_start = (draw_y < 0) ? 0 : draw_y;
-	int16_t x_end = ((draw_x + w) > ST7789_WIDTH) ? (ST7789_WIDTH - 1) : (draw_x + w - 1);
-	int16_t y_end = ((draw_y + h) > ST7789_HEIGHT) ? (ST7789_HEIGHT - 1) : (draw_y + h - 1);
-
-	// Calculate actual drawing dimensions
-	uint16_t draw_width = x_end - x_start + 1;
-	uint16_t draw_height = y_end - y_start + 1;
-
-	// Allocate buffer for character pixels (max typical glyph is ~30x30 = 900 pixels = 1800 bytes)
-	// Use stack allocation for reasonable sizes, fall back to pixel-by-pixel for huge glyphs
-	uint16_t pixel_count = draw_width * draw_height;
-
-	if (pixel_count > 1600) {
-		// Character too large for stack buffer - use slower method but still optimized
-		// This should rarely happen with normal fonts
-		ST7789_Select();
-		ST7789_SetAddressWindow(x_start, y_start, x_end, y_end);
-
-		for (uint16_t py = y_start; py <= y_end; py++) {
-			for (uint16_t px = x_start; px <= x_end; px++) {
-				// Calculate position in glyph bitmap
-				int16_t glyph_x = px - draw_x;
-				int16_t glyph_y = py - draw_y;
-
-				// Calculate bit position in packed bitmap
-				uint16_t bit_offset = bo * 8 + glyph_y * w + glyph_x;
-				uint16_t byte_offset = bit_offset / 8;
-				uint8_t bit_num = 7 - (bit_offset % 8);
-
-				// Read bit from bitmap
-				uint8_t bit = (bitmap[byte_offset] >> bit_num) & 0x01;
-
-				// Send pixel color
-				uint16_t pixel_color = bit ? color : bgcolor;
-				uint8_t data[] = {pixel_color >> 8, pixel_color & 0xFF};
-				ST7789_WriteData(data, sizeof(data));
-			}
-		}
+	// Glyph rows are packed back to back, without padding
+	ST7789_DrawBits_Internal(draw_x, draw_y, w, h, bitmap, (uint32_t)bo * 8, w, color, bgcolor);
+}
 
-		ST7789_UnSelect();
-		return;
+/**
+ * @brief Write a string using GFXfont format
+ * @param  x&y -> cursor position (baseline)
+ * @param str -> string to write
+ * @param font -> pointer to GFXfont structure
+ * @param color -> color of the string
+ * @param bgcolor -> background color of the string
+ * @return  none
+ */
+void ST7789_drawString(int16_t x, int16_t y, const char *str, const GFXfont *font, uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+
+	int16_t cursor_x = x;
+	int16_t cursor_y = y;
+
+	while (*str) {
+		char c = *str++;
+
+		// Check if character is in font range
+		if ((c < font->first) || (c > font->last)) {
+			continue;
+		}
+
+		// Get glyph for this character
+		GFXglyph *glyph = &font->glyph[c - font->first];
+
+		// Check for line wrap
+		if (cursor_x + glyph->xOffset + glyph->width >= ST7789_WIDTH) {
+			cursor_x = 0;
+			cursor_y += font->yAdvance;
+
+			// Stop if we've gone off bottom of screen
+			if (cursor_y >= ST7789_HEIGHT) {
+				break;
+			}
+
+			// Skip spaces at beginning of new line
+			if (c == ' ') {
+				continue;
+			}
+		}
+
+		// Draw the character
+		ST7789_drawChar(cursor_x, cursor_y, c, font, color, bgcolor);
+
+		// Advance cursor
+		cursor_x += glyph->xAdvance;
+	}
+}
+
+/**
+ * @brief Calculate bounding box for a text string
+ * @param str -> string to measure
+ * @param font -> pointer to GFX font
+ * @param w -> pointer to store calculated width
+ * @param h -> pointer to store calculated height
+ * @return none
+ * @note This function only calculates dimensions without rendering
+ */
+void ST7789_getTextBounds(const char *str, const GFXfont *font, uint16_t *w, uint16_t *h)
+{
+	if (str == NULL || font == NULL || w == NULL || h == NULL) {
+		return;
+	}
+
+	int16_t cursor_x = 0;
+	int16_t min_x = 0, max_x = 0;
+	int16_t min_y = 0, max_y = 0;
+	uint8_t first_char = 1;
+
+	while (*str) {
+		char c = *str++;
+
+		// Check if character is in font range
+		if ((c < font->first) || (c > font->last)) {
+			continue;
+		}
+
+		// Get glyph for this character
+		GFXglyph *glyph = &font->glyph[c - font->first];
+
+		if (first_char) {
+			// Initialize bounds with first character
+			min_x = cursor_x + glyph->xOffset;
+			max_x = min_x + glyph->width;
+			min_y = glyph->yOffset;
+			max_y = min_y + glyph->height;
+			first_char = 0;
+		} else {
+			// Expand bounds for subsequent characters
+			int16_t char_min_x = cursor_x + glyph->xOffset;
+			int16_t char_max_x = char_min_x + glyph->width;
+			int16_t char_min_y = glyph->yOffset;
+			int16_t char_max_y = char_min_y + glyph->height;
+
+			if (char_min_x < min_x) min_x = char_min_x;
+			if (char_max_x > max_x) max_x = char_max_x;
+			if (char_min_y < min_y) min_y = char_min_y;
+			if (char_max_y > max_y) max_y = char_max_y;
+		}
+
+		// Advance cursor
+		cursor_x += glyph->xAdvance;
+	}
+
+	// Calculate final dimensions
+	*w = (uint16_t)(max_x - min_x);
+	*h = (uint16_t)(max_y - min_y);
+}
+
+/**
+ * @brief Draw a filled Rectangle with single color
+ * @param  x&y -> coordinates of the starting point
+ * @param w&h -> width & height of the Rectangle
+ * @param color -> color of the Rectangle
+ * @return  none
+ */
+void ST7789_fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_FillArea_Internal(x, y, w, h, color);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a Triangle with single color
+ * @param  xi&yi -> 3 coordinates of 3 top points.
+ * @param color ->color of the lines
+ * @return  none
+ */
+void ST7789_drawTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	ST7789_Point_t points[3] = {{x1, y1}, {x2, y2}, {x3, y3}};
+
+	ST7789_Select();
+	ST7789_DrawPolyline_Internal(points, 3, 1, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw connected lines with single color
+ * @param points -> array of points
+ * @param count -> number of points
+ * @param color -> color of the lines
+ * @return  none
+ * @note Points shared by two segments are drawn once
+ */
+void ST7789_drawPolyline(const ST7789_Point_t *points, uint16_t count, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (points == NULL || count == 0) return;
+
+	ST7789_Select();
+	ST7789_DrawPolyline_Internal(points, count, 0, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/* Polygon edge walked from top to bottom.
+ * x is kept exact as x + err / den in 16.16 pixels, stepping by step + rem / den per row.
+ * x and step are 64-bit, edges between vertices near the int16 limits don't fit 16.16 in 32 bits.
+ */
+typedef struct {
+	int64_t x;
+	int32_t err;
+	int64_t step;
+	int32_t rem;
+	int32_t den;
+	int32_t end_row;            // First row below the edge
+} ST7789_Edge_t;
+
+/**
+ * @brief Floor division for a positive divisor
+ * @param num -> dividend
+ * @param den -> divisor, > 0
+ * @param rem -> pointer to store the remainder (0 <= rem < den)
+ * @return Quotient rounded down
+ */
+static int64_t ST7789_FloorDiv(int64_t num, int32_t den, int32_t *rem)
+{
+	int64_t q = num / den;
+	int64_t r = num - q * den;
+
+	if (r < 0) {
+		q--;
+		r += den;
+	}
+	*rem = (int32_t)r;
+	return q;
+}
+
+/**
+ * @brief Set up an edge for walking down from a row
+ * @param edge -> edge to set up
+ * @param xa&ya -> upper end point (24.8 pixels)
+ * @param xb&yb -> lower end point (24.8 pixels), yb > ya
+ * @param row -> first row to sample
+ * @return none
+ * @note Rows sample pixel centers, which sit on integer coordinates
+ */
+static void ST7789_EdgeSetup(ST7789_Edge_t *edge, int32_t xa, int32_t ya, int32_t xb, int32_t yb, int32_t row)
+{
+	int64_t dx = (int64_t)(xb - xa) * 256;
+
+	edge->den = yb - ya;
+	edge->step = ST7789_FloorDiv(dx * 256, edge->den, &edge->rem);
+	edge->x = (int64_t)xa * 256 + ST7789_FloorDiv(dx * ((int64_t)row * 256 - ya), edge->den, &edge->err);
+	edge->end_row = (yb + 255) >> 8;
+}
+
+/**
+ * @brief Advance an edge to the next row
+ * @param edge -> edge to advance
+ * @return none
+ */
+static inline void ST7789_EdgeStep(ST7789_Edge_t *edge)
+{
+	edge->x += edge->step;
+	edge->err += edge->rem;
+	if (edge->err >= edge->den) {
+		edge->err -= edge->den;
+		edge->x++;
+	}
+}
+
+/**
+ * @brief Get the first pixel column whose center is at or right of an edge
+ * @param edge -> edge on the current row
+ * @return Column index
+ */
+static inline int32_t ST7789_EdgeColumn(const ST7789_Edge_t *edge)
+{
+	return (int32_t)((edge->x + (edge->err > 0) + 0xFFFF) >> 16);
+}
+
+/**
+ * @brief Internal helper to fill a convex polygon into the span batch
+ * @param points -> vertices in order (either winding)
+ * @param count -> number of vertices
+ * @param frac_bits -> fractional bits of the vertex coordinates (0-8)
+ * @param color -> fill color
+ * @return none
+ * @note Edges are walked down in fixed point and each row becomes one span.
+ *       A pixel is filled when its center is inside; centers exactly on a
+ *       left or top edge are inside, on a right or bottom edge outside, so
+ *       polygons sharing an edge never draw a pixel twice.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_FillConvex_Internal(const ST7789_Point_t *points, uint16_t count, uint8_t frac_bits, uint16_t color)
+{
+	int32_t scale = 1 << (8 - frac_bits);
+	uint16_t top = 0;
+	int32_t ymin = INT32_MAX, ymax = INT32_MIN;
+
+	if (count < 3) return;
+
+	for (uint16_t i = 0; i < count; i++) {
+		int32_t y = points[i].y * scale;
+		if (y < ymin) {
+			ymin = y;
+			top = i;
+		}
+		if (y > ymax) ymax = y;
+	}
+
+	// Rows whose centers lie in [ymin, ymax)
+	int32_t row = (ymin + 255) >> 8;
+	int32_t end = (ymax + 255) >> 8;
+	if (row < st7789_clip.y0) row = st7789_clip.y0;
+	if (end > st7789_clip.y1 + 1) end = st7789_clip.y1 + 1;
+	if (row >= end) return;
+
+	// Two chains run down from the top vertex, one in each direction
+	ST7789_Edge_t edges[2];
+	uint16_t cur[2] = {top, top};
+	int8_t dir[2] = {1, -1};
+
+	for (uint8_t c = 0; c < 2; c++) {
+		edges[c].end_row = row;
+	}
+
+	for (; row < end; row++) {
+		for (uint8_t c = 0; c < 2; c++) {
+			uint16_t guard = count;
+
+			// Move to the edge covering this row
+			while (edges[c].end_row <= row && guard-- > 0) {
+				uint16_t next = (cur[c] + count + dir[c]) % count;
+				int32_t xa = points[cur[c]].x * scale, ya = points[cur[c]].y * scale;
+				int32_t xb = points[next].x * scale, yb = points[next].y * scale;
+
+				cur[c] = next;
+				if (yb > ya) {
+					ST7789_EdgeSetup(&edges[c], xa, ya, xb, yb, row);
+				} else {
+					edges[c].end_row = row;
+				}
+			}
+		}
+
+		// Centers in [left, right)
+		int32_t first = ST7789_EdgeColumn(&edges[0]);
+		int32_t last = ST7789_EdgeColumn(&edges[1]) - 1;
+		if (first > last + 1) {
+			int32_t swap = first;
+			first = last + 1;
+			last = swap - 1;
+		}
+		if (first <= last) {
+			ST7789_SpanAdd(first, row, last - first + 1, 1, color);
+		}
+
+		ST7789_EdgeStep(&edges[0]);
+		ST7789_EdgeStep(&edges[1]);
+	}
+}
+
+/**
+ * @brief Draw a filled Triangle with single color
+ * @param  xi&yi -> 3 coordinates of 3 top points.
+ * @param color ->color of the triangle
+ * @return  none
+ * @note Scanline filled with the top-left rule, triangles sharing an edge
+ *       don't overlap or leave gaps
+ */
+void ST7789_fillTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Point_t points[3] = {{x1, y1}, {x2, y2}, {x3, y3}};
+
+	ST7789_Select();
+	ST7789_FillConvex_Internal(points, 3, 0, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a filled convex polygon with single color
+ * @param points -> vertices in order (either winding)
+ * @param count -> number of vertices
+ * @param color -> fill color
+ * @return  none
+ * @note Same fill rule as ST7789_fillTriangle(), one span per row
+ */
+void ST7789_fillConvexPolygon(const ST7789_Point_t *points, uint16_t count, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (points == NULL) return;
+
+	ST7789_Select();
+	ST7789_FillConvex_Internal(points, count, 0, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/* Polygon edge waiting in the edge table */
+typedef struct {
+	ST7789_Edge_t walk;
+	int32_t xa, ya;             // Upper end point (24.8 pixels)
+	int32_t xb, yb;             // Lower end point (24.8 pixels)
+	int32_t start_row;          // First row sampled by the edge
+	int8_t winding;             // +1 if the polygon runs down along the edge, -1 if up
+} ST7789_PolyEdge_t;
+
+/* Edge table and active edge list of ST7789_fillPolygon() */
+static ST7789_PolyEdge_t st7789_poly_edges[ST7789_MAX_POLY_EDGES];
+static uint16_t st7789_poly_active[ST7789_MAX_POLY_EDGES];
+
+/**
+ * @brief Draw a filled polygon of any shape with single color
+ * @param points -> vertices in order, the polygon is closed automatically
+ * @param count -> number of vertices
+ * @param rule -> ST7789_FILL_EVEN_ODD or ST7789_FILL_NONZERO
+ * @param color -> fill color
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM on bad arguments or when
+ *         the polygon has more than ST7789_MAX_POLY_EDGES non-horizontal edges
+ *         (nothing is drawn then)
+ * @note Edges are sorted by their first row into an edge table and moved to
+ *       an active edge list kept in x order while walking down the rows.
+ *       Spans between crossings are merged per row and sent through the solid
+ *       fill path. Only rows inside the drawing area are walked. Pixel centers
+ *       follow the same top-left rule as ST7789_fillTriangle().
+ */
+ST7789_Status_t ST7789_fillPolygon(const ST7789_Point_t *points, uint16_t count, ST7789_FillRule_t rule, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return ST7789_ERR_INVALID_PARAM;
+	if (points == NULL || count < 3) return ST7789_ERR_INVALID_PARAM;
+	if (rule != ST7789_FILL_EVEN_ODD && rule != ST7789_FILL_NONZERO) return ST7789_ERR_INVALID_PARAM;
+
+	ST7789_PolyEdge_t *edges = st7789_poly_edges;
+	uint16_t *active = st7789_poly_active;
+
+	// Edge table: non-horizontal edges, upper end first
+	uint16_t edge_count = 0;
+	int32_t first_row = INT32_MAX, end_row = INT32_MIN;
+	int16_t xmin = INT16_MAX, xmax = INT16_MIN;
+
+	for (uint16_t i = 0; i < count; i++) {
+		const ST7789_Point_t *a = &points[i];
+		const ST7789_Point_t *b = &points[(i + 1) % count];
+
+		if (a->x < xmin) xmin = a->x;
+		if (a->x > xmax) xmax = a->x;
+		if (a->y == b->y) continue;
+		if (edge_count == ST7789_MAX_POLY_EDGES) return ST7789_ERR_INVALID_PARAM;
+
+		ST7789_PolyEdge_t *e = &edges[edge_count];
+		if (a->y < b->y) {
+			e->xa = a->x * 256; e->ya = a->y * 256;
+			e->xb = b->x * 256; e->yb = b->y * 256;
+			e->winding = 1;
+		} else {
+			e->xa = b->x * 256; e->ya = b->y * 256;
+			e->xb = a->x * 256; e->yb = a->y * 256;
+			e->winding = -1;
+		}
+		e->start_row = (e->ya + 255) >> 8;
+		e->walk.end_row = (e->yb + 255) >> 8;
+		if (e->start_row >= e->walk.end_row) continue;   // Between two pixel centers
+
+		if (e->start_row < first_row) first_row = e->start_row;
+		if (e->walk.end_row > end_row) end_row = e->walk.end_row;
+
+		// Insertion sort by first row
+		uint16_t j = edge_count++;
+		ST7789_PolyEdge_t edge = *e;
+		while (j > 0 && edges[j - 1].start_row > edge.start_row) {
+			edges[j] = edges[j - 1];
+			j--;
+		}
+		edges[j] = edge;
+	}
+
+	// Clip before rasterizing
+	int32_t row = (first_row < st7789_clip.y0) ? st7789_clip.y0 : first_row;
+	if (end_row > st7789_clip.y1 + 1) end_row = st7789_clip.y1 + 1;
+	if (xmax < st7789_clip.x0 || xmin > st7789_clip.x1) end_row = row;
+
+	uint16_t next_edge = 0, active_count = 0;
+
+	ST7789_Select();
+	for (; row < end_row; row++) {
+		// Move edges starting on this row (or above the clip) to the active list
+		while (next_edge < edge_count && edges[next_edge].start_row <= row) {
+			ST7789_PolyEdge_t *e = &edges[next_edge];
+			if (e->walk.end_row > row) {
+				ST7789_EdgeSetup(&e->walk, e->xa, e->ya, e->xb, e->yb, row);
+				active[active_count++] = next_edge;
+			}
+			next_edge++;
+		}
+
+		// Drop finished edges and keep the rest in x order (nearly sorted already)
+		uint16_t kept = 0;
+		for (uint16_t i = 0; i < active_count; i++) {
+			uint16_t idx = active[i];
+			if (edges[idx].walk.end_row <= row) continue;
+
+			uint16_t j = kept++;
+			while (j > 0 && edges[active[j - 1]].walk.x > edges[idx].walk.x) {
+				active[j] = active[j - 1];
+				j--;
+			}
+			active[j] = idx;
+		}
+		active_count = kept;
+
+		// Spans between crossings, touching spans merged
+		int32_t span_first = 0, span_last = -1;
+		int32_t winding = 0;
+
+		for (uint16_t i = 0; i + 1 < active_count; i++) {
+			ST7789_PolyEdge_t *e = &edges[active[i]];
+
+			winding = (rule == ST7789_FILL_NONZERO) ? winding + e->winding : winding ^ 1;
+			if (winding == 0) continue;
+
+			// Centers in [x_i, x_i+1)
+			int32_t first = ST7789_EdgeColumn(&e->walk);
+			int32_t last = ST7789_EdgeColumn(&edges[active[i + 1]].walk) - 1;
+			if (first > last) continue;
+
+			if (span_last >= span_first && first <= span_last + 1) {
+				if (last > span_last) span_last = last;
+			} else {
+				if (span_last >= span_first) {
+					ST7789_SpanAdd(span_first, row, span_last - span_first + 1, 1, color);
+				}
+				span_first = first;
+				span_last = last;
+			}
+		}
+		if (span_last >= span_first) {
+			ST7789_SpanAdd(span_first, row, span_last - span_first + 1, 1, color);
+		}
+
+		for (uint16_t i = 0; i < active_count; i++) {
+			ST7789_EdgeStep(&edges[active[i]].walk);
+		}
+	}
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+
+	return ST7789_OK;
+}
+
+/**
+ * @brief Internal helper to fill the rows of a rounded shape at one distance from the center
+ * @param x0&y0 -> center of the top-left corner circle
+ * @param sw&sh -> distance from the top-left to the bottom-right corner circle center
+ * @param k -> row distance from the corner circle centers
+ * @param hw -> half width of the corner circle on these rows
+ * @param color -> fill color
+ * @return none
+ */
+static void ST7789_FillRoundRows(int32_t x0, int32_t y0, int32_t sw, int32_t sh, int32_t k, int32_t hw, uint16_t color)
+{
+	if (k == 0) {
+		// The straight middle part is a single rectangle
+		ST7789_SpanAdd(x0 - hw, y0, 2 * hw + 1 + sw, sh + 1, color);
+	} else {
+		ST7789_SpanAdd(x0 - hw, y0 - k, 2 * hw + 1 + sw, 1, color);
+		ST7789_SpanAdd(x0 - hw, y0 + sh + k, 2 * hw + 1 + sw, 1, color);
+	}
+}
+
+/**
+ * @brief Integer square root
+ * @param n -> value
+ * @return floor(sqrt(n))
+ */
+static uint32_t ST7789_Isqrt(uint64_t n)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > n) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (n >= root + bit) {
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)root;
+}
+
+/**
+ * @brief Internal helper to get the midpoint circle state at a column
+ * @param r -> radius
+ * @param x -> column, 0 to r
+ * @param f -> pointer to store the decision value at (x, y)
+ * @return Row y the midpoint steps are on at column x
+ * @note The steps keep f = x^2 + 2x + y^2 - y - r^2 + 1 and y is the
+ *       largest value with y * (y - 1) < r^2 - x^2, so any column can be
+ *       started from without walking the ones before it.
+ */
+static int32_t ST7789_MidpointAt(int32_t r, int32_t x, int32_t *f)
+{
+	int64_t n = (int64_t)r * r - (int64_t)x * x;
+	int64_t y = (n > 0) ? (int64_t)ST7789_Isqrt(n) + 1 : 0;
+
+	while (y > 0 && y * (y - 1) >= n) {
+		y--;
+	}
+	*f = (int32_t)((int64_t)x * x + 2 * x + y * y - y - (int64_t)r * r + 1);
+	return (int32_t)y;
+}
+
+/**
+ * @brief Internal helper to fill a circle stretched into a rounded rectangle
+ * @param x0&y0 -> center of the top-left corner circle
+ * @param r -> corner radius
+ * @param sw&sh -> distance from the top-left to the bottom-right corner circle center
+ * @param color -> fill color
+ * @return none
+ * @note Every row gets exactly one span, with the same pixels as the midpoint
+ *       circle outline. Only the steps reaching rows inside the clip are
+ *       walked. Caller must flush the span batch.
+ */
+static void ST7789_FillRoundShape_Internal(int32_t x0, int32_t y0, int32_t r, int32_t sw, int32_t sh, uint16_t color)
+{
+	if (x0 + sw + r < st7789_clip.x0 || x0 - r > st7789_clip.x1 ||
+	    y0 + sh + r < st7789_clip.y0 || y0 - r > st7789_clip.y1) {
+		return;
+	}
+
+	// Row distances inside the clip, top rows are y0 - k and bottom rows y0 + sh + k
+	int32_t klo = r + 1, khi = -1;
+	int32_t lo = y0 - st7789_clip.y1, hi = y0 - st7789_clip.y0;
+	if (lo < 0) lo = 0;
+	if (hi > r) hi = r;
+	if (lo <= hi) {
+		klo = lo;
+		khi = hi;
+	}
+	lo = st7789_clip.y0 - y0 - sh;
+	hi = st7789_clip.y1 - y0 - sh;
+	if (lo < 0) lo = 0;
+	if (hi > r) hi = r;
+	if (lo <= hi) {
+		if (lo < klo) klo = lo;
+		if (hi > khi) khi = hi;
+	}
+	if (y0 <= st7789_clip.y1 && y0 + sh >= st7789_clip.y0) {
+		klo = 0;
+		if (khi < 0) khi = 0;
+	}
+	if (klo > khi) return;
+
+	// Find where the midpoint steps cross the diagonal, starting just before it
+	int32_t f;
+	int32_t x = ST7789_Isqrt((uint64_t)r * r / 2);
+	x = (x > 2) ? x - 2 : 0;
+	int32_t y = ST7789_MidpointAt(r, x, &f);
+	int32_t ddF_x = 2 * x + 1;
+	int32_t ddF_y = -2 * y;
+
+	while (x < y) {
+		if (f >= 0) {
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+	}
+
+	// Rows ye..xe (at most two) get their width from both octants
+	int32_t xe = x, ye = y;
+	int32_t zone[2] = {0, 0};
+
+	// Start at the first column whose rows are visible, at distance x or y
+	int64_t n = (int64_t)r * r - (int64_t)khi * (khi + 1);
+	x = (n > 0) ? (int32_t)ST7789_Isqrt(n - 1) + 1 : 0;
+	if (x > klo) x = klo;
+	y = ST7789_MidpointAt(r, x, &f);
+	ddF_x = 2 * x + 1;
+	ddF_y = -2 * y;
+
+	while (1) {
+		// Rows at distance x are as wide as y
+		if (x < ye) {
+			ST7789_FillRoundRows(x0, y0, sw, sh, x, y, color);
+		} else if (y > zone[x - ye]) {
+			zone[x - ye] = y;
+		}
+
+		uint8_t last = (x >= y);
+		int32_t next_y = y;
+
+		if (!last && f >= 0) {
+			next_y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+
+		// Rows at distance y are as wide as the last step on them
+		if (last || next_y != y) {
+			if (y > xe) {
+				ST7789_FillRoundRows(x0, y0, sw, sh, y, x, color);
+			} else if (x > zone[y - ye]) {
+				zone[y - ye] = x;
+			}
+		}
+
+		// No visible rows left at distance y, nor at distance x up to the diagonal
+		if (last || (next_y < klo && (x >= khi || klo > xe))) break;
+
+		y = next_y;
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+	}
+
+	for (int32_t k = ye; k <= xe; k++) {
+		ST7789_FillRoundRows(x0, y0, sw, sh, k, zone[k - ye], color);
+	}
+}
+
+/**
+ * @brief Draw a Filled circle with single color
+ * @param x0&y0 -> coordinate of circle center
+ * @param r -> radius of circle
+ * @param color -> color of circle
+ * @return  none
+ * @note Each row is one span written once
+ */
+void ST7789_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (r < 0) return;
+
+	ST7789_Select();
+	ST7789_FillRoundShape_Internal(x0, y0, r, 0, 0, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a filled ellipse with single color
+ * @param x0&y0 -> coordinate of ellipse center
+ * @param rx&ry -> horizontal & vertical radius, up to INT16_MAX
+ * @param color -> color of ellipse
+ * @return  none
+ * @note Covers the pixels inside the ellipse with radii grown by half a pixel,
+ *       each row is one span written once and only rows inside the clip
+ *       are walked. Larger radii draw nothing.
+ */
+void ST7789_fillEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (rx > INT16_MAX || ry > INT16_MAX) return;
+	if ((int32_t)x0 + rx < st7789_clip.x0 || (int32_t)x0 - rx > st7789_clip.x1 ||
+	    (int32_t)y0 + ry < st7789_clip.y0 || (int32_t)y0 - ry > st7789_clip.y1) {
+		return;
+	}
+
+	// x^2 / (rx + 1/2)^2 + y^2 / (ry + 1/2)^2 <= 1, scaled to integers.
+	// With radii up to INT16_MAX a2 * b2 and both terms fit in 64 bits.
+	uint64_t a2 = (uint64_t)(2 * rx + 1) * (2 * rx + 1);
+	uint64_t b2 = (uint64_t)(2 * ry + 1) * (2 * ry + 1);
+	uint64_t limit = a2 * b2 / 4;
+
+	// Rows inside the clip, the upper half is y0 - y and the lower half y0 + y
+	int32_t first = ry + 1, last = -1;
+	int32_t lo = y0 - st7789_clip.y1, hi = y0 - st7789_clip.y0;
+	if (lo < 0) lo = 0;
+	if (hi > ry) hi = ry;
+	if (lo <= hi) {
+		first = lo;
+		last = hi;
+	}
+	lo = st7789_clip.y0 - y0;
+	hi = st7789_clip.y1 - y0;
+	if (lo < 0) lo = 0;
+	if (hi > ry) hi = ry;
+	if (lo <= hi) {
+		if (lo < first) first = lo;
+		if (hi > last) last = hi;
+	}
+
+	// Widest x on the first visible row
+	int32_t x = ST7789_Isqrt((limit - (uint64_t)first * first * a2) / b2);
+	if (x > rx) x = rx;
+
+	ST7789_Select();
+	for (int32_t y = first; y <= last; y++) {
+		// Rows get narrower going out, so x only ever shrinks
+		while (x > 0 && (uint64_t)x * x * b2 + (uint64_t)y * y * a2 > limit) {
+			x--;
+		}
+
+		ST7789_SpanAdd(x0 - x, y0 - y, 2 * x + 1, 1, color);
+		if (y > 0) {
+			ST7789_SpanAdd(x0 - x, y0 + y, 2 * x + 1, 1, color);
+		}
+	}
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a filled rectangle with rounded corners
+ * @param x&y -> top-left corner coordinates
+ * @param w&h -> width and height
+ * @param r -> corner radius, limited to half the shorter side
+ * @param color -> fill color
+ * @return  none
+ * @note The straight middle part is one window, each corner row one span
+ */
+void ST7789_fillRoundRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (w == 0 || h == 0) return;
+
+	uint16_t max_r = ((w < h) ? w : h) / 2;
+	if (r > max_r) r = max_r;
+
+	// When r is half of an even side the corner centers on that side are -1 apart
+	ST7789_Select();
+	ST7789_FillRoundShape_Internal(x + r, y + r, r, w - 2 * r - 1, h - 2 * r - 1, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/* sin() of 0-90 degrees (Q14) */
+static const int16_t st7789_sin_table[91] = {
+	0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+	2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+	5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+	8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384
+};
+
+/* One row of an anti-aliased shape being written out */
+typedef struct {
+	int32_t x, y;		// first pixel of the edge segment in st7789_disp_buf
+	uint16_t count;		// pixels in the edge segment
+	int32_t solid_x;	// first pixel of the pending full-coverage run
+	int32_t solid;		// length of the pending full-coverage run
+	uint16_t color;
+	uint16_t bgcolor;
+} ST7789_AARow_t;
+
+/**
+ * @brief Sine of an angle in whole degrees
+ * @param deg -> angle in degrees, any value
+ * @return sin(deg) in Q14
+ */
+static int32_t ST7789_SinDeg(int32_t deg)
+{
+	deg %= 360;
+	if (deg < 0) deg += 360;
+
+	if (deg <= 90) return st7789_sin_table[deg];
+	if (deg <= 180) return st7789_sin_table[180 - deg];
+	if (deg <= 270) return -st7789_sin_table[deg - 180];
+	return -st7789_sin_table[360 - deg];
+}
+
+/**
+ * @brief Send the edge segment of an anti-aliased row
+ * @param row -> row state
+ * @return none
+ * @note Caller must handle ST7789_Select/UnSelect
+ */
+static void ST7789_AARowFlush(ST7789_AARow_t *row)
+{
+	if (row->count == 0) return;
+
+	ST7789_SetAddressWindow(row->x, row->y, row->x + row->count - 1, row->y);
+	ST7789_WriteData((uint8_t*)st7789_disp_buf, row->count * 2);
+	row->count = 0;
+}
+
+/**
+ * @brief Append a pixel to the edge segment of an anti-aliased row
+ * @param row -> row state
+ * @param x -> column of the pixel
+ * @param pixel -> final color of the pixel
+ * @return none
+ */
+static void ST7789_AARowPush(ST7789_AARow_t *row, int32_t x, uint16_t pixel)
+{
+	if (row->count == st7789_disp_buf_size || (row->count > 0 && row->x + row->count != x)) {
+		ST7789_AARowFlush(row);
+	}
+	if (row->count == 0) {
+		row->x = x;
+	}
+	st7789_disp_buf[row->count++] = (pixel >> 8) | (pixel << 8);
+}
+
+/**
+ * @brief Settle the pending full-coverage run of an anti-aliased row
+ * @param row -> row state
+ * @return none
+ * @note The run joins the edge segment when both fit in st7789_disp_buf, so
+ *       a row usually goes out as one window. Longer runs go to the span batch.
+ */
+static void ST7789_AARowSolid(ST7789_AARow_t *row)
+{
+	if (row->count + row->solid > st7789_disp_buf_size) {
+		// Span flushes reuse st7789_disp_buf
+		ST7789_AARowFlush(row);
+		ST7789_SpanAdd(row->solid_x, row->y, row->solid, 1, row->color);
+	} else {
+		for (int32_t i = 0; i < row->solid; i++) {
+			ST7789_AARowPush(row, row->solid_x + i, row->color);
+		}
+	}
+	row->solid = 0;
+}
+
+/**
+ * @brief Add pixels to an anti-aliased row, left to right without gaps
+ * @param row -> row state
+ * @param x -> column of the first pixel
+ * @param n -> number of pixels
+ * @param alpha -> coverage of the pixels (0-255)
+ * @return none
+ * @note Pixels with no coverage are left untouched
+ */
+static void ST7789_AARowAdd(ST7789_AARow_t *row, int32_t x, int32_t n, uint8_t alpha)
+{
+	if (alpha == 255) {
+		if (row->solid == 0) {
+			row->solid_x = x;
+		}
+		row->solid += n;
+		return;
+	}
+
+	ST7789_AARowSolid(row);
+	if (alpha == 0) {
+		ST7789_AARowFlush(row);
+		return;
+	}
+	for (int32_t i = 0; i < n; i++) {
+		ST7789_AARowPush(row, x + i, ST7789_BlendColor(row->color, row->bgcolor, alpha));
+	}
+}
+
+/**
+ * @brief Coverage of a pixel by the half plane on one side of a ray from the center
+ * @param dx&dy -> pixel position relative to the center
+ * @param ux&uy -> direction of the ray (Q14)
+ * @param side -> 1 for the clockwise side, -1 for the counterclockwise side
+ * @return coverage (0-255)
+ */
+static inline uint8_t ST7789_HalfPlaneCoverage(int32_t dx, int32_t dy, int32_t ux, int32_t uy, int32_t side)
+{
+	// Signed distance to the ray's line (Q14), covered from -1/2 to +1/2 pixel
+	int32_t a = (side * (ux * dy - uy * dx) + 8192) / 64;
+
+	return (a < 0) ? 0 : (a > 255) ? 255 : a;
+}
+
+/**
+ * @brief Internal helper to draw an anti-aliased arc of a ring
+ * @param x0&y0 -> center of the ring
+ * @param r -> outer radius
+ * @param t -> thickness, more than r fills the disc
+ * @param start&end -> angles in degrees, clockwise from 12 o'clock
+ * @param color -> color of the arc
+ * @param bgcolor -> background color the edge pixels are blended with
+ * @return none
+ * @note Edges sit half a pixel outside radius r and half a pixel inside
+ *       r - t + 1, matching the aliased circles. Per row the full-coverage
+ *       band and the hole come from integer square roots, only pixels in the
+ *       one pixel wide edge bands get a distance computed. The angular edges
+ *       are half planes through the center. Caller must handle
+ *       ST7789_Select/UnSelect and flush the span batch.
+ */
+static void ST7789_DrawArcAA_Internal(int32_t x0, int32_t y0, int32_t r, int32_t t, int32_t start, int32_t end,
+                                      uint16_t color, uint16_t bgcolor)
+{
+	if (start == end || t <= 0) return;
+
+	// Sweep of 0 after reduction is a full turn
+	int32_t sweep = (end - start) % 360;
+	if (sweep < 0) sweep += 360;
+	uint8_t wedge = (sweep != 0);
+
+	int32_t sx = ST7789_SinDeg(start), sy = -ST7789_SinDeg(start + 90);
+	int32_t ex = ST7789_SinDeg(end), ey = -ST7789_SinDeg(end + 90);
+
+	int32_t top = (y0 - r < st7789_clip.y0) ? st7789_clip.y0 - y0 : -r;
+	int32_t bottom = (y0 + r > st7789_clip.y1) ? st7789_clip.y1 - y0 : r;
+	int32_t ri = r - t;		// last radius of the hole
+	int32_t rf = r - t + 1;	// first radius fully inside the ring
+
+	ST7789_AARow_t row = {0};
+	row.color = color;
+	row.bgcolor = bgcolor;
+
+	for (int32_t dy = top; dy <= bottom; dy++) {
+		int64_t dy2 = (int64_t)dy * dy;
+		int32_t outer = ST7789_Isqrt((int64_t)(r + 1) * (r + 1) - dy2 - 1);
+		int32_t solid = ST7789_Isqrt((int64_t)r * r - dy2);
+		int32_t hole = (ri >= 0 && (int64_t)ri * ri >= dy2) ? (int32_t)ST7789_Isqrt((int64_t)ri * ri - dy2) : -1;
+		int32_t inner = (rf > 0 && (int64_t)rf * rf > dy2) ? (int32_t)ST7789_Isqrt((int64_t)rf * rf - dy2 - 1) : -1;
+
+		int32_t lo = (x0 - outer < st7789_clip.x0) ? st7789_clip.x0 - x0 : -outer;
+		int32_t hi = (x0 + outer > st7789_clip.x1) ? st7789_clip.x1 - x0 : outer;
+
+		row.y = y0 + dy;
+		for (int32_t dx = lo; dx <= hi; dx++) {
+			int32_t adx = abs(dx);
+			uint32_t alpha = 255;
+
+			if (adx <= hole) {
+				// Skip to the other side of the hole
+				ST7789_AARowAdd(&row, x0 + dx, 1, 0);
+				dx = (hole < hi) ? hole : hi;
+				continue;
+			}
+
+			if (adx > solid || adx <= inner) {
+				int32_t d = ST7789_Isqrt(((uint64_t)adx * adx + dy2) << 16);	// Q8
+				if (adx > solid) {
+					int32_t a = (r + 1) * 256 - d;
+					alpha = (a < 0) ? 0 : (a > 255) ? 255 : a;
+				}
+				if (adx <= inner) {
+					int32_t a = d - ri * 256;
+					alpha = alpha * ((a < 0) ? 0 : (a > 255) ? 255 : a) / 255;
+				}
+			} else if (!wedge) {
+				// Full-coverage band, up to the hole or the far edge
+				int32_t last = (dx < 0 && inner >= 0) ? -inner - 1 : solid;
+				if (last > hi) last = hi;
+				ST7789_AARowAdd(&row, x0 + dx, last - dx + 1, 255);
+				dx = last;
+				continue;
+			}
+
+			if (wedge && alpha != 0) {
+				uint8_t as = ST7789_HalfPlaneCoverage(dx, dy, sx, sy, 1);
+				uint8_t ae = ST7789_HalfPlaneCoverage(dx, dy, ex, ey, -1);
+				// Up to half a turn the arc is both half planes, beyond it either one
+				uint8_t aw = ((sweep <= 180) == (as < ae)) ? as : ae;
+				alpha = alpha * aw / 255;
+			}
+			ST7789_AARowAdd(&row, x0 + dx, 1, alpha);
+		}
+		ST7789_AARowSolid(&row);
+		ST7789_AARowFlush(&row);
+	}
+}
+
+/**
+ * @brief Draw an anti-aliased filled circle over a known background color
+ * @param x0&y0 -> coordinate of circle center
+ * @param r -> radius of circle
+ * @param color -> color of circle
+ * @param bgcolor -> background color the edge pixels are blended with
+ * @return  none
+ * @note Only the edge pixels on either side of a row are blended, the row
+ *       is written as one window
+ */
+void ST7789_fillCircleAA(int16_t x0, int16_t y0, uint16_t r, uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_DrawArcAA_Internal(x0, y0, r, (int32_t)r + 1, 0, 360, color, bgcolor);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw an anti-aliased ring over a known background color
+ * @param x0&y0 -> coordinate of ring center
+ * @param r -> outer radius
+ * @param thickness -> width of the ring in pixels
+ * @param color -> color of ring
+ * @param bgcolor -> background color the edge pixels are blended with
+ * @return  none
+ */
+void ST7789_drawRingAA(int16_t x0, int16_t y0, uint16_t r, uint16_t thickness, uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_DrawArcAA_Internal(x0, y0, r, thickness, 0, 360, color, bgcolor);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw an anti-aliased arc of a ring over a known background color
+ * @param x0&y0 -> coordinate of ring center
+ * @param r -> outer radius
+ * @param thickness -> width of the ring in pixels
+ * @param start_angle -> start of the arc in degrees, clockwise from 12 o'clock
+ * @param end_angle -> end of the arc in degrees, the arc runs clockwise from start_angle
+ * @param color -> color of arc
+ * @param bgcolor -> background color the edge pixels are blended with
+ * @return  none
+ * @note Equal angles draw nothing, angles a multiple of 360 apart draw the full ring
+ */
+void ST7789_drawArcAA(int16_t x0, int16_t y0, uint16_t r, uint16_t thickness, int16_t start_angle, int16_t end_angle,
+                      uint16_t color, uint16_t bgcolor)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_DrawArcAA_Internal(x0, y0, r, thickness, start_angle, end_angle, color, bgcolor);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Internal helper to clip a line segment to a box (Liang-Barsky)
+ * @param x0&y0 -> start point, moved onto the box when clipped
+ * @param x1&y1 -> end point, moved onto the box when clipped
+ * @param xmin&ymin&xmax&ymax -> box, inclusive
+ * @return 1 if part of the segment is inside the box, 0 otherwise
+ * @note The line parameter is kept in Q16, clipped points may land a
+ *       fraction of a unit off the box edge
+ */
+static uint8_t ST7789_ClipSegment(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1,
+                                  int32_t xmin, int32_t ymin, int32_t xmax, int32_t ymax)
+{
+	int32_t dx = *x1 - *x0, dy = *y1 - *y0;
+	int32_t p[4] = {-dx, dx, -dy, dy};
+	int32_t q[4] = {*x0 - xmin, xmax - *x0, *y0 - ymin, ymax - *y0};
+	int64_t t0 = 0, t1 = 65536;
+
+	for (uint8_t i = 0; i < 4; i++) {
+		if (p[i] == 0) {
+			if (q[i] < 0) return 0;
+			continue;
+		}
+
+		int64_t t = (int64_t)q[i] * 65536 / p[i];
+		if (p[i] < 0) {
+			if (t > t0) t0 = t;
+		} else {
+			if (t < t1) t1 = t;
+		}
+	}
+	if (t0 > t1) return 0;
+
+	int32_t sx = *x0, sy = *y0;
+	*x0 = sx + (int32_t)(dx * t0 / 65536);
+	*y0 = sy + (int32_t)(dy * t0 / 65536);
+	*x1 = sx + (int32_t)(dx * t1 / 65536);
+	*y1 = sy + (int32_t)(dy * t1 / 65536);
+	return 1;
+}
+
+/* Area where stroke geometry can still reach the drawing area (Q4) */
+typedef struct {
+	int32_t x0, y0, x1, y1;
+} ST7789_StrokeBox_t;
+
+/**
+ * @brief Internal helper to fill a disc for round caps and joins
+ * @param box -> reach of the stroke
+ * @param cx&cy -> center (Q4)
+ * @param hw -> radius (Q4)
+ * @param color -> fill color
+ * @return none
+ * @note The disc is a regular polygon with more sides for larger radii,
+ *       keeping the chords within a fraction of a pixel of the circle.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_StrokeDisc(const ST7789_StrokeBox_t *box, int32_t cx, int32_t cy, int32_t hw, uint16_t color)
+{
+	if (cx < box->x0 || cx > box->x1 || cy < box->y0 || cy > box->y1) return;
+
+	ST7789_Point_t pts[36];
+	int32_t step = (hw < 3 * 16) ? 45 : (hw < 8 * 16) ? 30 : (hw < 24 * 16) ? 20 : 10;
+	uint16_t n = 0;
+
+	for (int32_t a = 0; a < 360; a += step) {
+		pts[n].x = cx + (hw * ST7789_SinDeg(a + 90) + 8192) / 16384;
+		pts[n].y = cy + (hw * ST7789_SinDeg(a) + 8192) / 16384;
+		n++;
+	}
+	ST7789_FillConvex_Internal(pts, n, 4, color);
+}
+
+/**
+ * @brief Internal helper to fill the join between two stroke segments
+ * @param box -> reach of the stroke
+ * @param px&py -> shared point (Q4)
+ * @param ax&ay -> normal of the incoming segment, half the width long (Q4)
+ * @param bx&by -> normal of the outgoing segment (Q4)
+ * @param hw -> half the width (Q4)
+ * @param join -> join style
+ * @param color -> fill color
+ * @return none
+ * @note Only the wedge on the outer side of the turn is filled, the inner
+ *       side is already covered by the overlapping segments.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_StrokeJoin(const ST7789_StrokeBox_t *box, int32_t px, int32_t py, int32_t ax, int32_t ay,
+                              int32_t bx, int32_t by, int32_t hw, ST7789_LineJoin_t join, uint16_t color)
+{
+	int64_t cross = (int64_t)ax * by - (int64_t)ay * bx;
+	int64_t dot = (int64_t)ax * bx + (int64_t)ay * by;
+
+	if (cross == 0 && dot > 0) return;	// Straight on
+
+	if (join == ST7789_JOIN_ROUND) {
+		ST7789_StrokeDisc(box, px, py, hw, color);
+		return;
+	}
+	if (cross == 0) return;			// Turned back, no outer side
+	if (px < box->x0 || px > box->x1 || py < box->y0 || py > box->y1) return;
+
+	// Normals point right of the direction, a clockwise turn opens on the left
+	int32_t s = (cross > 0) ? -1 : 1;
+	ST7789_Point_t pts[4];
+	uint16_t n = 0;
+
+	pts[n].x = px;
+	pts[n++].y = py;
+	pts[n].x = px + s * ax;
+	pts[n++].y = py + s * ay;
+
+	// Miter length is hw / cos(turn / 2), (hw^2 + dot) is 2 hw^2 cos^2(turn / 2)
+	int64_t hw2 = (int64_t)hw * hw;
+	int64_t denom = hw2 + dot;
+	if (join == ST7789_JOIN_MITER && denom * ST7789_MITER_LIMIT * ST7789_MITER_LIMIT >= 2 * hw2) {
+		pts[n].x = px + (int32_t)(s * (ax + bx) * hw2 / denom);
+		pts[n++].y = py + (int32_t)(s * (ay + by) * hw2 / denom);
+	}
+
+	pts[n].x = px + s * bx;
+	pts[n++].y = py + s * by;
+	ST7789_FillConvex_Internal(pts, n, 4, color);
+}
+
+/* Stroke being built point by point (Q4) */
+typedef struct {
+	ST7789_StrokeBox_t box;
+	int32_t hw;                 // Half the width
+	int32_t px, py;             // Last point
+	int32_t nx, ny;             // Normal of the last segment
+	uint8_t points;             // Whether a point was added yet
+	uint8_t started;            // Whether a segment was drawn yet
+	ST7789_LineJoin_t join;
+	ST7789_LineCap_t cap;
+	uint16_t color;
+} ST7789_Stroke_t;
+
+/**
+ * @brief Internal helper to start a stroke
+ * @param s -> stroke state
+ * @param width -> stroke width in pixels, at least 1
+ * @param join -> join style between segments
+ * @param cap -> cap style at both ends
+ * @param color -> stroke color
+ * @return none
+ */
+static void ST7789_StrokeBegin(ST7789_Stroke_t *s, uint8_t width, ST7789_LineJoin_t join, ST7789_LineCap_t cap,
+                               uint16_t color)
+{
+	int32_t reach = (ST7789_MITER_LIMIT * width / 2 + 2) * 16;
+
+	s->box.x0 = st7789_clip.x0 * 16 - reach;
+	s->box.y0 = st7789_clip.y0 * 16 - reach;
+	s->box.x1 = st7789_clip.x1 * 16 + reach;
+	s->box.y1 = st7789_clip.y1 * 16 + reach;
+	s->hw = width * 8;
+	s->points = 0;
+	s->started = 0;
+	s->join = join;
+	s->cap = cap;
+	s->color = color;
+}
+
+/**
+ * @brief Internal helper to add a point to a stroke
+ * @param s -> stroke state
+ * @param bx&by -> point (Q4)
+ * @return none
+ * @note Each segment is a quad filled by ST7789_FillConvex_Internal(), the
+ *       join with the previous segment and a round start cap are extra
+ *       convex polygons. Segments are clipped to the drawing area grown by
+ *       the reach of a miter first. Repeated points are skipped.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_StrokeTo(ST7789_Stroke_t *s, int32_t bx, int32_t by)
+{
+	if (!s->points) {
+		s->px = bx;
+		s->py = by;
+		s->points = 1;
+		return;
+	}
+
+	int32_t ax = s->px, ay = s->py;
+	int32_t dx = bx - ax, dy = by - ay;
+	if (dx == 0 && dy == 0) return;
+
+	int32_t len = ST7789_Isqrt((int64_t)dx * dx + (int64_t)dy * dy);
+	int32_t sx = (int32_t)((int64_t)-dy * s->hw / len);
+	int32_t sy = (int32_t)((int64_t)dx * s->hw / len);
+
+	if (s->started) {
+		ST7789_StrokeJoin(&s->box, ax, ay, s->nx, s->ny, sx, sy, s->hw, s->join, s->color);
+	} else if (s->cap == ST7789_CAP_ROUND) {
+		ST7789_StrokeDisc(&s->box, ax, ay, s->hw, s->color);
+	}
+
+	s->px = bx;
+	s->py = by;
+	s->nx = sx;
+	s->ny = sy;
+	s->started = 1;
+
+	if (ST7789_ClipSegment(&ax, &ay, &bx, &by, s->box.x0, s->box.y0, s->box.x1, s->box.y1)) {
+		ST7789_Point_t quad[4] = {
+			{ax + sx, ay + sy}, {bx + sx, by + sy}, {bx - sx, by - sy}, {ax - sx, ay - sy}
+		};
+		ST7789_FillConvex_Internal(quad, 4, 4, s->color);
+	}
+}
+
+/**
+ * @brief Internal helper to finish a stroke with its end cap
+ * @param s -> stroke state
+ * @return none
+ * @note Caller must flush the span batch
+ */
+static void ST7789_StrokeEnd(ST7789_Stroke_t *s)
+{
+	if (s->points && s->cap == ST7789_CAP_ROUND) {
+		ST7789_StrokeDisc(&s->box, s->px, s->py, s->hw, s->color);
+	}
+}
+
+/**
+ * @brief Internal helper to stroke connected lines into the span batch
+ * @param points -> array of points
+ * @param count -> number of points
+ * @param width -> stroke width in pixels
+ * @param join -> join style between segments
+ * @param cap -> cap style at both ends
+ * @param color -> stroke color
+ * @return none
+ * @note Points are handed to ST7789_StrokeTo() in Q4.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_DrawStroke_Internal(const ST7789_Point_t *points, uint16_t count, uint8_t width,
+                                       ST7789_LineJoin_t join, ST7789_LineCap_t cap, uint16_t color)
+{
+	if (count == 0 || width == 0) return;
+
+	ST7789_Stroke_t stroke;
+	ST7789_StrokeBegin(&stroke, width, join, cap, color);
+	for (uint16_t i = 0; i < count; i++) {
+		ST7789_StrokeTo(&stroke, points[i].x * 16, points[i].y * 16);
+	}
+	ST7789_StrokeEnd(&stroke);
+}
+
+/**
+ * @brief Draw a line of a given width
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param width -> line width in pixels
+ * @param cap -> cap style at both ends
+ * @param color -> color of the line
+ * @return none
+ * @note The stroke is centered on the line, butt caps end exactly at the
+ *       end points. Pixels are filled when their center is inside.
+ */
+void ST7789_drawThickLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width,
+                          ST7789_LineCap_t cap, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Point_t points[2] = {{x0, y0}, {x1, y1}};
+
+	ST7789_Select();
+	ST7789_DrawStroke_Internal(points, 2, width, ST7789_JOIN_MITER, cap, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw connected lines of a given width
+ * @param points -> array of points
+ * @param count -> number of points
+ * @param width -> line width in pixels
+ * @param join -> join style between segments, sharp miters past
+ *                ST7789_MITER_LIMIT fall back to bevels
+ * @param cap -> cap style at the first and last point
+ * @param color -> color of the lines
+ * @return none
+ * @note All segments, joins and caps go through the span batch in one pass
+ */
+void ST7789_drawThickPolyline(const ST7789_Point_t *points, uint16_t count, uint8_t width,
+                              ST7789_LineJoin_t join, ST7789_LineCap_t cap, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (points == NULL) return;
+
+	ST7789_Select();
+	ST7789_DrawStroke_Internal(points, count, width, join, cap, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/* Bezier flattening limits */
+#define ST7789_CURVE_MAX_DEPTH 10	// At most 2^10 segments per curve
+
+/* Cubic Bezier piece, control points in Q8 */
+typedef struct {
+	int32_t x[4];
+	int32_t y[4];
+} ST7789_Bezier_t;
+
+/* Flattened points on their way to the line or stroke rasterizer */
+typedef struct {
+	ST7789_Stroke_t stroke;     // Thick curves
+	ST7789_Point_t last;        // Thin curves, last point in pixels
+	uint8_t count;              // Thin curves, whether last is set
+	uint8_t drawn;              // Thin curves, whether a segment went out yet
+	uint8_t width;
+	uint16_t color;
+} ST7789_Flatten_t;
+
+/**
+ * @brief Internal helper to add a flattened point to a curve
+ * @param f -> flattening state
+ * @param x&y -> point (Q8)
+ * @return none
+ * @note Thin curves round the point to whole pixels and draw each segment
+ *       as soon as it ends. Thick curves keep it in Q4 for the stroker, so
+ *       joins between short segments don't follow the pixel grid.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_CurvePoint(ST7789_Flatten_t *f, int32_t x, int32_t y)
+{
+	if (f->width > 1) {
+		ST7789_StrokeTo(&f->stroke, (x + 8) >> 4, (y + 8) >> 4);
+		return;
+	}
+
+	ST7789_Point_t p = {(int16_t)((x + 128) >> 8), (int16_t)((y + 128) >> 8)};
+
+	if (f->count > 0) {
+		if (f->last.x == p.x && f->last.y == p.y) return;
+		ST7789_DrawLine_Internal(f->last.x, f->last.y, p.x, p.y, f->color,
+		                         f->drawn ? ST7789_LINE_END : ST7789_LINE_BOTH);
+		f->drawn = 1;
+	}
+	f->last = p;
+	f->count = 1;
+}
+
+/**
+ * @brief Internal helper to flatten a cubic Bezier curve into the span batch
+ * @param curve -> control points (Q8)
+ * @param width -> line width in pixels, 1 for a thin line
+ * @param cap -> cap style at both ends of a thick curve
+ * @param color -> color of the curve
+ * @return none
+ * @note Pieces are halved (de Casteljau) until their control points are
+ *       within ST7789_CURVE_TOLERANCE_Q4 of the chord, using an explicit
+ *       stack. Pieces outside the drawing area are kept as one chord.
+ *       Caller must flush the span batch.
+ */
+static void ST7789_DrawBezier_Internal(const ST7789_Bezier_t *curve, uint8_t width, ST7789_LineCap_t cap,
+                                       uint16_t color)
+{
+	if (width == 0) return;
+
+	ST7789_Flatten_t f;
+	ST7789_Bezier_t stack[ST7789_CURVE_MAX_DEPTH + 1];
+	uint8_t level[ST7789_CURVE_MAX_DEPTH + 1];
+	uint8_t top = 0;
+	int32_t reach = (width / 2 + 2) * 256;
+	int32_t bx0 = st7789_clip.x0 * 256 - reach, by0 = st7789_clip.y0 * 256 - reach;
+	int32_t bx1 = st7789_clip.x1 * 256 + reach, by1 = st7789_clip.y1 * 256 + reach;
+
+	f.count = 0;
+	f.drawn = 0;
+	f.width = width;
+	f.color = color;
+	if (width > 1) {
+		ST7789_StrokeBegin(&f.stroke, width, ST7789_JOIN_MITER, cap, color);
+	}
+	ST7789_CurvePoint(&f, curve->x[0], curve->y[0]);
+	stack[top] = *curve;
+	level[top++] = 0;
+
+	while (top > 0) {
+		top--;
+		ST7789_Bezier_t b = stack[top];
+		uint8_t depth = level[top];
+
+		// 3/4 of the larger second difference bounds the distance to the chord
+		int32_t d1 = abs(b.x[0] - 2 * b.x[1] + b.x[2]) + abs(b.y[0] - 2 * b.y[1] + b.y[2]);
+		int32_t d2 = abs(b.x[1] - 2 * b.x[2] + b.x[3]) + abs(b.y[1] - 2 * b.y[2] + b.y[3]);
+		uint8_t flat = 3 * ((d1 > d2) ? d1 : d2) <= 4 * 16 * ST7789_CURVE_TOLERANCE_Q4;
+
+		int32_t xmin = b.x[0], xmax = b.x[0], ymin = b.y[0], ymax = b.y[0];
+		for (uint8_t i = 1; i < 4; i++) {
+			if (b.x[i] < xmin) xmin = b.x[i];
+			if (b.x[i] > xmax) xmax = b.x[i];
+			if (b.y[i] < ymin) ymin = b.y[i];
+			if (b.y[i] > ymax) ymax = b.y[i];
+		}
+		uint8_t outside = xmax < bx0 || xmin > bx1 || ymax < by0 || ymin > by1;
+
+		if (flat || outside || depth == ST7789_CURVE_MAX_DEPTH) {
+			ST7789_CurvePoint(&f, b.x[3], b.y[3]);
+			continue;
+		}
+
+		// Split at t = 1/2, the second half is pushed first so the first half comes out next
+		ST7789_Bezier_t l, r;
+		for (uint8_t i = 0; i < 2; i++) {
+			int32_t *p = i ? b.y : b.x;
+			int32_t *lp = i ? l.y : l.x;
+			int32_t *rp = i ? r.y : r.x;
+			int32_t m01 = (p[0] + p[1]) >> 1, m12 = (p[1] + p[2]) >> 1, m23 = (p[2] + p[3]) >> 1;
+			int32_t m012 = (m01 + m12) >> 1, m123 = (m12 + m23) >> 1;
+			int32_t mid = (m012 + m123) >> 1;
+			lp[0] = p[0];
+			lp[1] = m01;
+			lp[2] = m012;
+			lp[3] = mid;
+			rp[0] = mid;
+			rp[1] = m123;
+			rp[2] = m23;
+			rp[3] = p[3];
+		}
+		stack[top] = r;
+		level[top++] = depth + 1;
+		stack[top] = l;
+		level[top++] = depth + 1;
+	}
+
+	if (width > 1) {
+		ST7789_StrokeEnd(&f.stroke);
+	} else if (!f.drawn) {
+		ST7789_SpanAdd(f.last.x, f.last.y, 1, 1, color);
+	}
+}
+
+/**
+ * @brief Draw a quadratic Bezier curve
+ * @param x0&y0 -> coordinate of the start point
+ * @param cx&cy -> coordinate of the control point
+ * @param x1&y1 -> coordinate of the end point
+ * @param width -> line width in pixels, 1 for a thin line
+ * @param cap -> cap style at both ends of a thick curve
+ * @param color -> color of the curve
+ * @return none
+ * @note The curve is raised to a cubic and flattened like ST7789_drawCubicBezier()
+ */
+void ST7789_drawQuadBezier(int16_t x0, int16_t y0, int16_t cx, int16_t cy, int16_t x1, int16_t y1,
+                           uint8_t width, ST7789_LineCap_t cap, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	// Cubic control points are 2/3 of the way from the ends to the quadratic one
+	ST7789_Bezier_t curve = {
+		{x0 * 256, (x0 * 256 + cx * 512) / 3, (x1 * 256 + cx * 512) / 3, x1 * 256},
+		{y0 * 256, (y0 * 256 + cy * 512) / 3, (y1 * 256 + cy * 512) / 3, y1 * 256}
+	};
+
+	ST7789_Select();
+	ST7789_DrawBezier_Internal(&curve, width, cap, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a cubic Bezier curve
+ * @param x0&y0 -> coordinate of the start point
+ * @param cx0&cy0 -> coordinate of the first control point
+ * @param cx1&cy1 -> coordinate of the second control point
+ * @param x1&y1 -> coordinate of the end point
+ * @param width -> line width in pixels, 1 for a thin line
+ * @param cap -> cap style at both ends of a thick curve
+ * @param color -> color of the curve
+ * @return none
+ * @note The curve is split until each piece is within ST7789_CURVE_TOLERANCE_Q4
+ *       of a straight segment. Thin curves round the segment ends to whole
+ *       pixels for the run-batched line rasterizer and land within about 1.2
+ *       pixels of the exact curve. Thick ones are stroked with miter joins
+ *       from the 1/16 pixel ends. Either way the cost follows the pixel
+ *       length rather than the number of segments.
+ */
+void ST7789_drawCubicBezier(int16_t x0, int16_t y0, int16_t cx0, int16_t cy0, int16_t cx1, int16_t cy1,
+                            int16_t x1, int16_t y1, uint8_t width, ST7789_LineCap_t cap, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Bezier_t curve = {
+		{x0 * 256, cx0 * 256, cx1 * 256, x1 * 256},
+		{y0 * 256, cy0 * 256, cy1 * 256, y1 * 256}
+	};
+
+	ST7789_Select();
+	ST7789_DrawBezier_Internal(&curve, width, cap, color);
+	ST7789_SpanFlush();
+	ST7789_UnSelect();
+}
+
+/* 4x4 Bayer threshold matrix */
+static const uint8_t st7789_bayer4[4][4] = {
+	{0, 8, 2, 10},
+	{12, 4, 14, 6},
+	{3, 11, 1, 9},
+	{15, 7, 13, 5}
+};
+
+/* Gradient being generated */
+typedef struct {
+	int32_t c0[3];		// start color channels (R5, G6, B5)
+	int32_t dc[3];		// end minus start channels
+	uint8_t dither;
+	uint8_t radial;
+	// Linear: position (Q16) at the rect origin and its steps per pixel
+	int32_t t0, dtx, dty;
+	// Radial: center, radius (Q8 and squared) and 2^24 / radius
+	int32_t cx, cy;
+	uint32_t r_q8, inv;
+	uint64_t r2;
+} ST7789_Gradient_t;
+
+/**
+ * @brief Set up the color ramp of a gradient
+ * @param g -> gradient
+ * @param color0 -> color at position 0
+ * @param color1 -> color at position 1
+ * @param dither -> Whether to dither with the 4x4 Bayer matrix
+ * @return none
+ */
+static void ST7789_GradientColors(ST7789_Gradient_t *g, uint16_t color0, uint16_t color1, uint8_t dither)
+{
+	g->c0[0] = color0 >> 11;
+	g->c0[1] = (color0 >> 5) & 0x3F;
+	g->c0[2] = color0 & 0x1F;
+	g->dc[0] = (int32_t)(color1 >> 11) - g->c0[0];
+	g->dc[1] = (int32_t)((color1 >> 5) & 0x3F) - g->c0[1];
+	g->dc[2] = (int32_t)(color1 & 0x1F) - g->c0[2];
+	g->dither = dither;
+}
+
+/**
+ * @brief Get the color of a gradient at a position
+ * @param g -> gradient
+ * @param t -> position along the ramp (Q16, 0-65536)
+ * @param x&y -> screen coordinates of the pixel, select the dither threshold
+ * @return RGB565 color
+ * @note Channels are interpolated in their own units with 11 fractional bits,
+ *       the fraction is rounded or compared to the Bayer threshold
+ */
+static inline uint16_t ST7789_GradientPixel(const ST7789_Gradient_t *g, int32_t t, int32_t x, int32_t y)
+{
+	int32_t thr = g->dither ? (2 * st7789_bayer4[y & 3][x & 3] + 1) * 64 : 1024;
+	int32_t r = ((g->c0[0] << 11) + ((g->dc[0] * t) >> 5) + thr) >> 11;
+	int32_t gr = ((g->c0[1] << 11) + ((g->dc[1] * t) >> 5) + thr) >> 11;
+	int32_t b = ((g->c0[2] << 11) + ((g->dc[2] * t) >> 5) + thr) >> 11;
+
+	return (uint16_t)((r << 11) | (gr << 5) | b);
+}
+
+/**
+ * @brief Internal helper to fill a rectangle with a gradient
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @param g -> gradient
+ * @return none
+ * @note The rectangle is one window, pixels are generated into
+ *       st7789_disp_buf and sent each time it fills up
+ */
+static void ST7789_FillGradient_Internal(int16_t x, int16_t y, uint16_t w, uint16_t h, const ST7789_Gradient_t *g)
+{
+	int16_t cx = x, cy = y;
+	uint16_t cw = w, ch = h;
+	if (!ST7789_ClipArea(&cx, &cy, &cw, &ch)) return;
+
+	uint16_t fill = 0;
+
+	ST7789_Select();
+	ST7789_SetAddressWindow(cx, cy, cx + cw - 1, cy + ch - 1);
+	for (int32_t py = cy; py < cy + ch; py++) {
+		int32_t t = g->t0 + (py - y) * g->dty + (cx - x) * g->dtx;
+		int32_t dy = py - g->cy;
+
+		for (int32_t px = cx; px < cx + cw; px++, t += g->dtx) {
+			int32_t pos = t;
+
+			if (g->radial) {
+				int32_t dx = px - g->cx;
+				uint32_t d2 = (uint32_t)(dx * dx) + (uint32_t)(dy * dy);
+				uint32_t d = (d2 < g->r2) ? ST7789_Isqrt((uint64_t)d2 << 16) : g->r_q8;
+				pos = (d >= g->r_q8) ? 65536 : (int32_t)((d * g->inv) >> 16);
+			}
+			if (pos < 0) pos = 0;
+			if (pos > 65536) pos = 65536;
+
+			uint16_t pixel = ST7789_GradientPixel(g, pos, px, py);
+			st7789_disp_buf[fill++] = (pixel >> 8) | (pixel << 8);
+			if (fill == st7789_disp_buf_size) {
+				ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+				fill = 0;
+			}
+		}
+	}
+	if (fill > 0) {
+		ST7789_WriteData((uint8_t*)st7789_disp_buf, fill * 2);
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Fill a rectangle with a linear gradient
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @param color0 -> color at the start of the gradient
+ * @param color1 -> color at the end of the gradient
+ * @param angle -> direction in degrees, clockwise from "to top", 90 runs left to right
+ * @param dither -> Whether to dither the ramp with a 4x4 Bayer matrix
+ * @return none
+ * @note As in CSS, the gradient line is sized so the corners on either end
+ *       get exactly color0 and color1. Generated per chunk in st7789_disp_buf,
+ *       no image is needed.
+ */
+void ST7789_fillRectGradient(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color0, uint16_t color1,
+                             int16_t angle, uint8_t dither)
+{
+	if (!ST7789_isInitialized()) return;
+	if (w == 0 || h == 0) return;
+
+	ST7789_Gradient_t g = {0};
+	ST7789_GradientColors(&g, color0, color1, dither);
+
+	// Direction (Q14) and length of the gradient line between pixel centers
+	int32_t ux = ST7789_SinDeg(angle), uy = -ST7789_SinDeg(angle + 90);
+	int64_t len = (int64_t)(w - 1) * abs(ux) + (int64_t)(h - 1) * abs(uy);
+
+	if (len > 0) {
+		// Position 1/2 at the center, doubled coordinates keep it integer
+		g.t0 = 32768 + (int32_t)(((int64_t)(1 - w) * ux + (int64_t)(1 - h) * uy) * 32768 / len);
+		g.dtx = (int32_t)((int64_t)ux * 65536 / len);
+		g.dty = (int32_t)((int64_t)uy * 65536 / len);
+	}
+
+	ST7789_FillGradient_Internal(x, y, w, h, &g);
+}
+
+/**
+ * @brief Fill a rectangle with a radial gradient
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @param cx&cy -> screen coordinates of the gradient center
+ * @param radius -> distance at which color1 is reached
+ * @param color0 -> color at the center
+ * @param color1 -> color at radius and beyond
+ * @param dither -> Whether to dither the ramp with a 4x4 Bayer matrix
+ * @return none
+ * @note Distances come from an integer square root, only for pixels
+ *       inside the radius
+ */
+void ST7789_fillRectRadialGradient(int16_t x, int16_t y, uint16_t w, uint16_t h, int16_t cx, int16_t cy,
+                                   uint16_t radius, uint16_t color0, uint16_t color1, uint8_t dither)
+{
+	if (!ST7789_isInitialized()) return;
+	if (w == 0 || h == 0) return;
+
+	ST7789_Gradient_t g = {0};
+	ST7789_GradientColors(&g, color0, color1, dither);
+
+	g.radial = 1;
+	g.cx = cx;
+	g.cy = cy;
+	g.r_q8 = (uint32_t)radius << 8;
+	g.r2 = (uint64_t)radius * radius;
+	g.inv = (radius > 0) ? (1UL << 24) / radius : 0;
+
+	ST7789_FillGradient_Internal(x, y, w, h, &g);
+}
+
+
+/**
+ * @brief Get the geometry of the panel scan axis for the current rotation
+ * @param shift -> pointer to store the address of the first visible line
+ * @param lines -> pointer to store the number of visible lines
+ * @return 1 if addresses run against the gate direction (MADCTL MY set), 0 otherwise
+ * @note The scan axis is the logical y axis in rotation 0/2 and the x axis in rotation 1/3
+ */
+static uint8_t ST7789_GetScanAxis(uint16_t *shift, uint16_t *lines)
+{
+	if (st7789_config.rotation & 1) {
+		*shift = ST7789_X_SHIFT;
+		*lines = ST7789_WIDTH;
+	} else {
+		*shift = ST7789_Y_SHIFT;
+		*lines = ST7789_HEIGHT;
+	}
+
+	// Rotations 0 and 1 set MADCTL_MY
+	return (st7789_config.rotation <= 1);
+}
+
+/**
+ * @brief Fill lines along the scan axis with single color
+ * @param line -> first logical line along the scan axis
+ * @param count -> number of lines
+ * @param color -> color to fill with
+ * @return none
+ */
+static void ST7789_FillScanLines(uint16_t line, uint16_t count, uint16_t color)
+{
+	if (st7789_config.rotation & 1) {
+		ST7789_fillRect(line, 0, count, ST7789_HEIGHT, color);
+	} else {
+		ST7789_fillRect(0, line, ST7789_WIDTH, count, color);
+	}
+}
+
+/**
+ * @brief Program the vertical scrolling definition (VSCRDEF)
+ * @param start -> address of the first scrolled line along the scan axis
+ * @param lines -> number of scrolled lines
+ * @return none
+ * @note Everything outside [start, start + lines) becomes top/bottom fixed area
+ */
+static void ST7789_SetScrollRegion_Internal(uint16_t start, uint16_t lines)
+{
+	uint16_t shift, visible;
+	uint16_t tfa, bfa;
+
+	// Fixed areas are defined in gate order, mirror them when MY is set
+	if (ST7789_GetScanAxis(&shift, &visible)) {
+		tfa = ST7789_GRAM_LINES - start - lines;
+	} else {
+		tfa = start;
+	}
+	bfa = ST7789_GRAM_LINES - tfa - lines;
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_VSCRDEF);
+	{
+		uint8_t data[] = {tfa >> 8, tfa & 0xFF, lines >> 8, lines & 0xFF, bfa >> 8, bfa & 0xFF};
+		ST7789_WriteData(data, sizeof(data));
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Program the vertical scroll start address (VSCSAD)
+ * @param start -> address of the first scrolled line along the scan axis
+ * @param lines -> number of scrolled lines
+ * @param offset -> lines the content moved towards the start of the axis
+ * @return none
+ */
+static void ST7789_SetScrollStart_Internal(uint16_t start, uint16_t lines, uint16_t offset)
+{
+	uint16_t shift, visible;
+	uint16_t vsp;
+
+	offset %= lines;
+	if (ST7789_GetScanAxis(&shift, &visible)) {
+		// Gate order is reversed, scrolling "up" in address space is scrolling "down" in GRAM
+		vsp = (ST7789_GRAM_LINES - start - lines) + ((lines - offset) % lines);
+	} else {
+		vsp = start + offset;
+	}
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_VSCSAD);
+	{
+		uint8_t data[] = {vsp >> 8, vsp & 0xFF};
+		ST7789_WriteData(data, sizeof(data));
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Define the hardware scrolling area
+ * @param top_fixed -> fixed lines at the start of the scan axis (top in rotation 0/2, left in 1/3)
+ * @param bottom_fixed -> fixed lines at the end of the scan axis
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM if no line is left to scroll
+ * @note Resets the scroll offset. Hidden GRAM lines are folded into the fixed areas,
+ *       so the scroll area always wraps inside the visible part of the panel.
+ */
+ST7789_Status_t ST7789_setScrollArea(uint16_t top_fixed, uint16_t bottom_fixed)
+{
+	if (!ST7789_isInitialized()) return ST7789_ERR_INVALID_PARAM;
+
+	uint16_t shift, lines;
+	ST7789_GetScanAxis(&shift, &lines);
+
+	if ((uint32_t)top_fixed + bottom_fixed >= lines) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// Partial mode stops scrolling, they can't be combined
+	if (st7789_partial.enabled) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// Scrolling and page flipping share the scroll definition
+	if (st7789_page.enabled) {
+		ST7789_pageFlipDisable();
+	}
+
+	st7789_scroll.top_fixed = top_fixed;
+	st7789_scroll.bottom_fixed = bottom_fixed;
+	st7789_scroll.offset = 0;
+	st7789_scroll.enabled = 1;
+
+	lines -= top_fixed + bottom_fixed;
+	ST7789_SetScrollRegion_Internal(shift + top_fixed, lines);
+	ST7789_SetScrollStart_Internal(shift + top_fixed, lines, 0);
+
+	return ST7789_OK;
+}
+
+/**
+ * @brief Set the scroll offset of the scrolling area
+ * @param offset -> lines the content is moved towards the start of the scan axis
+ * @return none
+ * @note Only the 2-byte scroll start address is sent, no pixel data is transferred
+ */
+void ST7789_setScrollOffset(uint16_t offset)
+{
+	if (!ST7789_isInitialized()) return;
+	if (!st7789_scroll.enabled) return;
+
+	uint16_t shift, lines;
+	ST7789_GetScanAxis(&shift, &lines);
+	lines -= st7789_scroll.top_fixed + st7789_scroll.bottom_fixed;
+
+	st7789_scroll.offset = offset % lines;
+	ST7789_SetScrollStart_Internal(shift + st7789_scroll.top_fixed, lines, st7789_scroll.offset);
+}
+
+/**
+ * @brief Get the current scroll offset
+ * @return Scroll offset in lines (0 when scrolling is not set up)
+ */
+uint16_t ST7789_getScrollOffset(void)
+{
+	return st7789_scroll.offset;
+}
+
+/**
+ * @brief Map an on-screen line of the scan axis to its drawing coordinate
+ * @param screen_line -> line as seen on the panel (y in rotation 0/2, x in 1/3)
+ * @return Coordinate to pass to the drawing functions to paint that line
+ */
+uint16_t ST7789_scrollMapLine(uint16_t screen_line)
+{
+	if (!st7789_scroll.enabled) return screen_line;
+
+	uint16_t shift, lines;
+	ST7789_GetScanAxis(&shift, &lines);
+	if (screen_line >= lines - st7789_scroll.bottom_fixed) return screen_line;
+	if (screen_line < st7789_scroll.top_fixed) return screen_line;
+
+	lines -= st7789_scroll.top_fixed + st7789_scroll.bottom_fixed;
+	return st7789_scroll.top_fixed + (screen_line - st7789_scroll.top_fixed + st7789_scroll.offset) % lines;
+}
+
+/**
+ * @brief Scroll the scrolling area and clear only the newly exposed lines
+ * @param lines -> lines to scroll, positive moves content towards the start of the scan axis
+ * @param color -> color of the exposed lines
+ * @return none
+ * @note The offset is written before the exposed lines are cleared, so they
+ *       show stale content until the fill lands instead of blanking lines that
+ *       are still visible. Exposed lines can be redrawn afterwards through
+ *       ST7789_scrollMapLine()
+ */
+void ST7789_scroll(int16_t lines, uint16_t color)
+{
+	if (!ST7789_isInitialized()) return;
+	if (!st7789_scroll.enabled || lines == 0) return;
+
+	uint16_t shift, area;
+	ST7789_GetScanAxis(&shift, &area);
+	area -= st7789_scroll.top_fixed + st7789_scroll.bottom_fixed;
+
+	uint16_t count = (lines < 0) ? -lines : lines;
+	if (count > area) {
+		count = area;
+	}
+
+	// GRAM lines leaving the screen are the ones re-entering at the other end
+	uint16_t first = (lines > 0) ? st7789_scroll.offset : (st7789_scroll.offset + area - count) % area;
+	uint16_t head = area - first;
+	if (head > count) {
+		head = count;
+	}
+
+	// Move first so the old content is never cleared while still on screen
+	if (lines > 0) {
+		ST7789_setScrollOffset(st7789_scroll.offset + count);
+	} else {
+		ST7789_setScrollOffset(st7789_scroll.offset + area - count);
+	}
+
+	ST7789_FillScanLines(st7789_scroll.top_fixed + first, head, color);
+	if (count > head) {
+		ST7789_FillScanLines(st7789_scroll.top_fixed, count - head, color);
+	}
+}
+
+
+/**
+ * @brief Enable GRAM page flipping for a band of the screen
+ * @param band_start -> first line of the band along the scan axis (y in rotation 0/2, x in 1/3)
+ * @param band_lines -> number of lines in the band
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM if the band can't be double buffered
+ * @note The band must touch the start or the end of the scan axis and fit in the
+ *       GRAM lines hidden on that side (e.g. 80 lines on 240x240, 40 on 135x240).
+ *       170x320 panels use the whole GRAM and have no room for a back page.
+ */
+ST7789_Status_t ST7789_pageFlipEnable(uint16_t band_start, uint16_t band_lines)
+{
+	if (!ST7789_isInitialized()) return ST7789_ERR_INVALID_PARAM;
+
+	uint16_t shift, lines;
+	uint16_t region_start;
+	ST7789_GetScanAxis(&shift, &lines);
+
+	if (band_lines == 0 || (uint32_t)band_start + band_lines > lines) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// Pick the hidden GRAM lines adjacent to the band
+	if ((band_start + band_lines == lines) &&
+	    (shift + lines + band_lines <= ST7789_GRAM_LINES)) {
+		st7789_page.back_offset = band_lines;
+		region_start = shift + band_start;
+	} else if ((band_start == 0) && (shift >= band_lines)) {
+		st7789_page.back_offset = -(int16_t)band_lines;
+		region_start = shift - band_lines;
+	} else {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// Partial mode stops scrolling, they can't be combined
+	if (st7789_partial.enabled) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// Scrolling and page flipping share the scroll definition
+	st7789_scroll.enabled = 0;
+	st7789_scroll.offset = 0;
+
+	st7789_page.band_start = band_start;
+	st7789_page.band_lines = band_lines;
+	st7789_page.redirect = 0;
+	st7789_page.front = 0;
+	st7789_page.enabled = 1;
+
+	ST7789_SetScrollRegion_Internal(region_start, band_lines * 2);
+	ST7789_SetScrollStart_Internal(region_start, band_lines * 2, 0);
+
+	return ST7789_OK;
+}
+
+/**
+ * @brief Disable GRAM page flipping and show the band lines again
+ * @return none
+ * @note If the hidden page was on screen, the band shows the older page afterwards
+ */
+void ST7789_pageFlipDisable(void)
+{
+	if (!ST7789_isInitialized()) return;
+	if (!st7789_page.enabled) return;
+
+	st7789_page.enabled = 0;
+	st7789_page.redirect = 0;
+	st7789_page.front = 0;
+	ST7789_UpdateClip();
+
+	// Default definition: whole GRAM scrolled by nothing
+	ST7789_SetScrollRegion_Internal(0, ST7789_GRAM_LINES);
+	ST7789_SetScrollStart_Internal(0, ST7789_GRAM_LINES, 0);
+}
+
+/**
+ * @brief Redirect drawing inside the band to the off-screen page
+ * @return none
+ * @note Use the band's on-screen coordinates. Only draw inside the band until
+ *       ST7789_pageFlip() is called, other lines would land in the wrong place.
+ */
+void ST7789_pageFlipDrawBack(void)
+{
+	if (!st7789_page.enabled) return;
+	st7789_page.redirect = 1;
+	ST7789_UpdateClip();
+}
+
+/**
+ * @brief Show the off-screen page and end drawing redirection
+ * @return none
+ * @note The switch is a single VSCSAD write, the panel picks it up on its next frame.
+ *       Normal drawing and reads follow the page on screen. Fills crossing the
+ *       band edge are split there, other windows (images, text) must not cross it
+ *       while the copy is on screen.
+ */
+void ST7789_pageFlip(void)
+{
+	if (!ST7789_isInitialized()) return;
+	if (!st7789_page.enabled) return;
+
+	uint16_t lines = st7789_page.band_lines;
+	uint16_t shift, visible;
+	uint16_t region_start;
+	ST7789_GetScanAxis(&shift, &visible);
+	region_start = shift + st7789_page.band_start;
+	if (st7789_page.back_offset < 0) {
+		region_start -= lines;
+	}
+
+	st7789_page.front ^= 1;
+	st7789_page.redirect = 0;
+	ST7789_UpdateClip();
+	ST7789_SetScrollStart_Internal(region_start, lines * 2, st7789_page.front ? lines : 0);
+}
+
+/**
+ * @brief Enter partial display mode, only scanning a band of the panel
+ * @param start -> first line of the band along the scan axis (y in rotation 0/2, x in 1/3)
+ * @param lines -> number of lines in the band
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM if the band is outside the screen
+ * @note Lines outside the band are not refreshed and drawing to them is skipped.
+ *       Partial mode ends hardware scrolling and page flipping.
+ */
+ST7789_Status_t ST7789_setPartialArea(uint16_t start, uint16_t lines)
+{
+	if (!ST7789_isInitialized()) return ST7789_ERR_INVALID_PARAM;
+
+	uint16_t shift, visible;
+	uint16_t sr, er;
+	uint8_t mirrored = ST7789_GetScanAxis(&shift, &visible);
+
+	if (lines == 0 || (uint32_t)start + lines > visible) {
+		return ST7789_ERR_INVALID_PARAM;
+	}
+
+	// PTLON leaves scroll mode, drop the scroll and page flipping state
+	if (st7789_page.enabled) {
+		ST7789_pageFlipDisable();
+	}
+	st7789_scroll.enabled = 0;
+	st7789_scroll.offset = 0;
+
+	// Partial area is defined in gate lines, mirror it when MY is set
+	if (mirrored) {
+		sr = ST7789_GRAM_LINES - (shift + start + lines);
+	} else {
+		sr = shift + start;
+	}
+	er = sr + lines - 1;
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_PTLAR);
+	{
+		uint8_t data[] = {sr >> 8, sr & 0xFF, er >> 8, er & 0xFF};
+		ST7789_WriteData(data, sizeof(data));
+	}
+	ST7789_WriteCommand(ST7789_PTLON);
+	ST7789_UnSelect();
+
+	st7789_partial.start = start;
+	st7789_partial.lines = lines;
+	st7789_partial.enabled = 1;
+	ST7789_UpdateClip();
+
+	return ST7789_OK;
+}
+
+/**
+ * @brief Leave partial display mode and scan the whole panel again
+ * @return none
+ * @note Lines outside the former band were not kept up to date, redraw them.
+ *       Like partial mode, NORON ends hardware scrolling and page flipping.
+ */
+void ST7789_setNormalMode(void)
+{
+	if (!ST7789_isInitialized()) return;
+
+	// NORON leaves scroll mode, drop the scroll and page flipping state
+	if (st7789_page.enabled) {
+		ST7789_pageFlipDisable();
+	}
+	st7789_scroll.enabled = 0;
+	st7789_scroll.offset = 0;
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_NORON);
+	ST7789_UnSelect();
+
+	st7789_partial.enabled = 0;
+	ST7789_UpdateClip();
+}
+
+/**
+ * @brief Enable/Disable idle mode (8 colors, one bit per channel)
+ * @param idle -> Whether to enter idle mode
+ * @return none
+ * @note Only the MSB of each color channel is displayed, GRAM content is kept
+ */
+void ST7789_setIdleMode(uint8_t idle)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_WriteCommand(idle ? ST7789_IDMON : ST7789_IDMOFF);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Open/Close tearing effect line
+ * @param tear -> Whether to tear
+ * @return none
+ */
+void ST7789_tearEffect(uint8_t tear)
+{
+	if (!ST7789_isInitialized()) return;
+	ST7789_Select();
+	ST7789_WriteCommand(tear ? 0x35 /* TEON */ : 0x34 /* TEOFF */);
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Enable the TE output on a scanline and start counting TE pulses
+ * @param scanline -> line along the scan axis (y in rotation 0/2, x in 1/3) at which TE fires
+ * @return none
+ * @note Route the TE pin to an EXTI line and call ST7789_vsyncIRQHandler() from its
+ *       callback. Choose the scanline just after the first line you update, so the
+ *       transfer starts right behind the panel refresh and never overtakes it.
+ */
+void ST7789_vsyncEnable(uint16_t scanline)
+{
+	if (!ST7789_isInitialized()) return;
+
+	uint16_t shift, lines;
+	uint16_t gate_line;
+	uint8_t mirrored = ST7789_GetScanAxis(&shift, &lines);
+
+	if (scanline >= lines) {
+		scanline = lines - 1;
 	}
 
-	// Use stack buffer for efficient rendering
-	uint16_t char_buffer[pixel_count];
+	// STE counts gate lines from the start of the panel refresh
+	if (mirrored) {
+		gate_line = ST7789_GRAM_LINES - 1 - (shift + scanline);
+	} else {
+		gate_line = shift + scanline;
+	}
+
+	// TEON with TEM = 0 selects V-blank TE, STE comes last to move it to the scanline
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_TEON);
+	ST7789_WriteSmallData(0x00);
+	ST7789_WriteCommand(ST7789_STE);
+	{
+		uint8_t data[] = {gate_line >> 8, gate_line & 0xFF};
+		ST7789_WriteData(data, sizeof(data));
+	}
+	ST7789_UnSelect();
+
+	st7789_vsync.in_frame = 0;
+	st7789_vsync.pending = 0;
+	st7789_vsync.enabled = 1;
+}
+
+/**
+ * @brief Disable the TE output and TE synchronization
+ * @return none
+ */
+void ST7789_vsyncDisable(void)
+{
+	if (!ST7789_isInitialized()) return;
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_TEOFF);
+	ST7789_UnSelect();
+
+	st7789_vsync.enabled = 0;
+	st7789_vsync.in_frame = 0;
+	st7789_vsync.pending = 0;
+}
+
+/**
+ * @brief Count a TE pulse and start the scheduled flush
+ * @return none
+ * @note Call from the TE pin EXTI callback, or from a timer to simulate TE on the host.
+ *       The scheduled flush runs inside this call, so the SPI DMA interrupt must be
+ *       able to preempt the TE interrupt. With ST7789_TE_PIN defined, a TE pulse
+ *       pending on its EXTI line when the flush ends is counted as a missed deadline.
+ */
+void ST7789_vsyncIRQHandler(void)
+{
+	st7789_vsync.te_count++;
+
+	if (!st7789_vsync.pending || !ST7789_isInitialized()) return;
+
+	st7789_vsync.flush(st7789_vsync.flush_ctx);
+
+	st7789_vsync.stats.frames++;
+#ifdef ST7789_TE_PIN
+	// The next TE edge is latched while this interrupt runs, a set flag means the flush overran it
+	if (__HAL_GPIO_EXTI_GET_IT(ST7789_TE_PIN) != 0) {
+		st7789_vsync.stats.missed++;
+	}
+#endif
+	st7789_vsync.pending = 0;
+}
+
+/**
+ * @brief Schedule a flush to start on the next TE pulse
+ * @param flush -> function sending the frame, e.g. a wrapper around
+ *                 ST7789_compositorFlush() or ST7789_canvasFlush()
+ * @param ctx -> argument passed to flush
+ * @return ST7789_OK on success, ST7789_ERR_INVALID_PARAM if TE sync is off or flush is NULL
+ * @note The transfer starts from the TE interrupt, right behind the scanline set with
+ *       ST7789_vsyncEnable(), and races the refresh down the screen. A flush scheduled
+ *       again before its pulse replaces the previous one. Don't draw while
+ *       ST7789_vsyncPending() returns 1, the flush owns the bus until then.
+ */
+ST7789_Status_t ST7789_vsyncSchedule(ST7789_FlushFn_t flush, void *ctx)
+{
+	if (!st7789_vsync.enabled || flush == NULL) return ST7789_ERR_INVALID_PARAM;
+
+	// The TE interrupt only reads flush and ctx while pending is set
+	st7789_vsync.pending = 0;
+	st7789_vsync.flush = flush;
+	st7789_vsync.flush_ctx = ctx;
+	st7789_vsync.pending = 1;
+
+	return ST7789_OK;
+}
+
+/**
+ * @brief Check if a scheduled flush has not finished yet
+ * @return 1 while the flush waits for its TE pulse or runs, 0 otherwise
+ */
+uint8_t ST7789_vsyncPending(void)
+{
+	return st7789_vsync.pending;
+}
+
+/**
+ * @brief Wait for the next TE pulse before starting a frame transfer
+ * @return 1 if synchronized to a TE pulse, 0 on timeout or when TE sync is disabled
+ * @note Draw the frame right after this call and close it with ST7789_vsyncEnd()
+ */
+uint8_t ST7789_vsyncBegin(void)
+{
+	if (!st7789_vsync.enabled) return 0;
+
+	uint32_t start = HAL_GetTick();
+	uint32_t count = st7789_vsync.te_count;
+	uint8_t synced = 1;
+
+	while (st7789_vsync.te_count == count) {
+		if ((HAL_GetTick() - start) >= ST7789_VSYNC_TIMEOUT_MS) {
+			st7789_vsync.stats.timeouts++;
+			synced = 0;
+			break;
+		}
+	}
+
+	st7789_vsync.stats.last_wait_ms = HAL_GetTick() - start;
+	st7789_vsync.frame_te = st7789_vsync.te_count;
+	st7789_vsync.in_frame = 1;
+
+	return synced;
+}
+
+/**
+ * @brief Close a frame transfer started with ST7789_vsyncBegin()
+ * @return none
+ * @note A TE pulse during the transfer means the refresh caught up with it (missed deadline)
+ */
+void ST7789_vsyncEnd(void)
+{
+	if (!st7789_vsync.in_frame) return;
+
+	st7789_vsync.stats.frames++;
+	if (st7789_vsync.te_count != st7789_vsync.frame_te) {
+		st7789_vsync.stats.missed++;
+	}
+	st7789_vsync.in_frame = 0;
+}
+
+/**
+ * @brief Get TE synchronization statistics
+ * @param stats -> pointer to store the statistics
+ * @return none
+ */
+void ST7789_getVsyncStats(ST7789_VsyncStats_t *stats)
+{
+	if (stats == NULL) return;
+	*stats = st7789_vsync.stats;
+}
+
+/**
+ * @brief Reset TE synchronization statistics
+ * @return none
+ */
+void ST7789_resetVsyncStats(void)
+{
+	memset(&st7789_vsync.stats, 0, sizeof(st7789_vsync.stats));
+}
+
+
+/**
+ * @brief Set the panel refresh rate in normal mode
+ * @param hz -> requested refresh rate (39-119 Hz)
+ * @return Refresh rate actually selected (closest FRCTRL2 setting)
+ */
+uint8_t ST7789_setFrameRate(uint8_t hz)
+{
+	if (!ST7789_isInitialized()) return st7789_pacing.rate;
+
+	uint8_t rtna = 0;
+	for (uint8_t i = 1; i < sizeof(st7789_frame_rates); i++) {
+		if (abs(st7789_frame_rates[i] - hz) < abs(st7789_frame_rates[rtna] - hz)) {
+			rtna = i;
+		}
+	}
+
+	ST7789_Select();
+	ST7789_WriteCommand(ST7789_FRCTRL2);
+	ST7789_WriteSmallData(rtna);
+	ST7789_UnSelect();
+
+	st7789_pacing.rate = st7789_frame_rates[rtna];
+	st7789_pacing.period_us = 1000000 / st7789_pacing.rate;
+
+	return st7789_pacing.rate;
+}
+
+/**
+ * @brief Get the panel refresh rate in normal mode
+ * @return Refresh rate in Hz
+ */
+uint8_t ST7789_getFrameRate(void)
+{
+	return st7789_pacing.rate;
+}
+
+/**
+ * @brief Start a paced frame, waiting for its slot in the refresh period
+ * @return none
+ * @note With TE synchronization enabled the frame starts on the next TE pulse instead
+ */
+void ST7789_frameBegin(void)
+{
+	if (!st7789_pacing.running) {
+		st7789_pacing.slot_ms = HAL_GetTick();
+		st7789_pacing.slot_frac_us = 0;
+		st7789_pacing.running = 1;
+	}
+
+	if (st7789_vsync.enabled) {
+		ST7789_vsyncBegin();
+	} else {
+		while ((int32_t)(HAL_GetTick() - st7789_pacing.slot_ms) < 0)
+		{}
+	}
+
+	st7789_pacing.start_ms = HAL_GetTick();
+}
+
+/**
+ * @brief Finish a paced frame and account its time against the refresh period
+ * @return none
+ */
+void ST7789_frameEnd(void)
+{
+	if (!st7789_pacing.running) return;
+
+	uint32_t now = HAL_GetTick();
+	uint32_t work_ms = now - st7789_pacing.start_ms;
+
+	if (st7789_vsync.enabled) {
+		ST7789_vsyncEnd();
+	}
+
+	st7789_pacing.stats.frames++;
+	st7789_pacing.stats.frame_time_ms = work_ms;
+	st7789_pacing.stats.slack_ms = (int32_t)(st7789_pacing.period_us / 1000) - (int32_t)work_ms;
+
+	// Move to the next slot, every slot already passed is a dropped frame
+	do {
+		uint32_t frac = st7789_pacing.slot_frac_us + st7789_pacing.period_us;
+		st7789_pacing.slot_ms += frac / 1000;
+		st7789_pacing.slot_frac_us = frac % 1000;
+		if ((int32_t)(now - st7789_pacing.slot_ms) > 0) {
+			st7789_pacing.stats.dropped++;
+		}
+	} while ((int32_t)(now - st7789_pacing.slot_ms) > 0);
+}
+
+/**
+ * @brief Get frame pacing statistics
+ * @param stats -> pointer to store the statistics
+ * @return none
+ */
+void ST7789_getFrameStats(ST7789_FrameStats_t *stats)
+{
+	if (stats == NULL) return;
+	*stats = st7789_pacing.stats;
+}
+
+/**
+ * @brief Reset frame pacing statistics and restart slot tracking
+ * @return none
+ */
+void ST7789_resetFrameStats(void)
+{
+	memset(&st7789_pacing.stats, 0, sizeof(st7789_pacing.stats));
+	st7789_pacing.running = 0;
+}
+
 
-	// Pre-calculate swapped colors for big-endian format
-	uint16_t color_swapped = (color >> 8) | (color << 8);
-	uint16_t bgcolor_swapped = (bgcolor >> 8) | (bgcolor << 8);
+/**
+ * @brief Initialize a layer compositor
+ * @param comp -> compositor to initialize
+ * @param layers -> layer stack, bottom layer first
+ * @param count -> number of layers
+ * @param background -> color below the bottom layer
+ * @return none
+ * @note The whole screen is marked as damaged, the first flush draws everything
+ */
+void ST7789_compositorInit(ST7789_Compositor_t *comp, ST7789_Layer_t *layers, uint8_t count, uint16_t background)
+{
+	if (comp == NULL) return;
 
-	// Fill buffer with character pixels
-	uint16_t buf_idx = 0;
-	for (uint16_t py = y_start; py <= y_end; py++) {
-		for (uint16_t px = x_start; px <= x_end; px++) {
-			// Calculate position in glyph bitmap
-			int16_t glyph_x = px - draw_x;
-			int16_t glyph_y = py - draw_y;
+	comp->layers = layers;
+	comp->count = (layers != NULL) ? count : 0;
+	comp->background = background;
+	comp->dirty_count = 0;
 
-			// Calculate bit position in packed bitmap
-			uint16_t bit_offset = bo * 8 + glyph_y * w + glyph_x;
-			uint16_t byte_offset = bit_offset / 8;
-			uint8_t bit_num = 7 - (bit_offset % 8);
+	ST7789_compositorInvalidate(comp, 0, 0, ST7789_WIDTH, ST7789_HEIGHT);
+}
 
-			// Read bit from bitmap
-			uint8_t bit = (bitmap[byte_offset] >> bit_num) & 0x01;
+/**
+ * @brief Mark a screen region as damaged
+ * @param comp -> compositor
+ * @param x&y -> top-left corner of the region
+ * @param w&h -> width & height of the region
+ * @return none
+ * @note Overlapping or touching regions are merged. When the list is full the
+ *       region is merged into the entry that grows the least.
+ */
+void ST7789_compositorInvalidate(ST7789_Compositor_t *comp, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	if (comp == NULL) return;
+
+	// Clip to screen
+	int32_t x0 = x, y0 = y;
+	int32_t x1 = x0 + w, y1 = y0 + h;	// exclusive
+	if (x0 < 0) x0 = 0;
+	if (y0 < 0) y0 = 0;
+	if (x1 > ST7789_WIDTH) x1 = ST7789_WIDTH;
+	if (y1 > ST7789_HEIGHT) y1 = ST7789_HEIGHT;
+	if (x0 >= x1 || y0 >= y1) return;
+
+	uint8_t i = 0;
+	while (i < comp->dirty_count) {
+		ST7789_Rect_t *d = &comp->dirty[i];
+
+		if ((x0 <= d->x + d->w) && (d->x <= x1) && (y0 <= d->y + d->h) && (d->y <= y1)) {
+			// Absorb the existing region and rescan, the union may touch others
+			if (d->x < x0) x0 = d->x;
+			if (d->y < y0) y0 = d->y;
+			if (d->x + d->w > x1) x1 = d->x + d->w;
+			if (d->y + d->h > y1) y1 = d->y + d->h;
+			comp->dirty[i] = comp->dirty[--comp->dirty_count];
+			i = 0;
+		} else {
+			i++;
+		}
+	}
 
-			// Set pixel color in buffer (big-endian format)
-			char_buffer[buf_idx++] = bit ? color_swapped : bgcolor_swapped;
+	if (comp->dirty_count == ST7789_MAX_DIRTY_RECTS) {
+		// Merge with the region whose bounding box grows the least
+		uint8_t best = 0;
+		uint32_t best_growth = UINT32_MAX;
+
+		for (i = 0; i < comp->dirty_count; i++) {
+			ST7789_Rect_t *d = &comp->dirty[i];
+			int32_t ux0 = (d->x < x0) ? d->x : x0;
+			int32_t uy0 = (d->y < y0) ? d->y : y0;
+			int32_t ux1 = (d->x + d->w > x1) ? d->x + d->w : x1;
+			int32_t uy1 = (d->y + d->h > y1) ? d->y + d->h : y1;
+			uint32_t growth = (uint32_t)((ux1 - ux0) * (uy1 - uy0)) - (uint32_t)d->w * d->h;
+
+			if (growth < best_growth) {
+				best_growth = growth;
+				best = i;
+			}
 		}
+
+		ST7789_Rect_t *d = &comp->dirty[best];
+		if (d->x < x0) x0 = d->x;
+		if (d->y < y0) y0 = d->y;
+		if (d->x + d->w > x1) x1 = d->x + d->w;
+		if (d->y + d->h > y1) y1 = d->y + d->h;
+		comp->dirty[best] = comp->dirty[--comp->dirty_count];
 	}
 
-	// Send entire character in single transaction
-	ST7789_Select();
-	ST7789_SetAddressWindow(x_start, y_start, x_end, y_end);
-	ST7789_WriteData((uint8_t*)char_buffer, pixel_count * 2);
-	ST7789_UnSelect();
+	ST7789_Rect_t *d = &comp->dirty[comp->dirty_count++];
+	d->x = x0;
+	d->y = y0;
+	d->w = x1 - x0;
+	d->h = y1 - y0;
 }
 
 /**
- * @brief Write a string using GFXfont format
- * @param  x&y -> cursor position (baseline)
- * @param str -> string to write
- * @param font -> pointer to GFXfont structure
- * @param color -> color of the string
- * @param bgcolor -> background color of the string
- * @return  none
+ * @brief Mark a region of a layer as damaged
+ * @param comp -> compositor
+ * @param index -> layer index
+ * @param x&y -> top-left corner of the region, in layer coordinates
+ * @param w&h -> width & height of the region, 0 for the whole layer
+ * @return none
  */
-void ST7789_drawString(uint16_t x, uint16_t y, const char *str, const GFXfont *font, uint16_t color, uint16_t bgcolor)
+void ST7789_compositorInvalidateLayer(ST7789_Compositor_t *comp, uint8_t index, int16_t x, int16_t y, uint16_t w, uint16_t h)
 {
-	if (!ST7789_isInitialized()) return;
-
-	int16_t cursor_x = x;
-	int16_t cursor_y = y;
+	if (comp == NULL || index >= comp->count) return;
 
-	while (*str) {
-		char c = *str++;
+	ST7789_Layer_t *layer = &comp->layers[index];
+	if (w == 0 || h == 0) {
+		x = 0;
+		y = 0;
+		w = layer->width;
+		h = layer->height;
+	}
 
-		// Check if character is in font range
-		if ((c < font->first) || (c > font->last)) {
-			continue;
-		}
+	ST7789_compositorInvalidate(comp, layer->x + x, layer->y + y, w, h);
+}
 
-		// Get glyph for this character
-		GFXglyph *glyph = &font->glyph[c - font->first];
+/**
+ * @brief Move a layer, damaging its old and new position
+ * @param comp -> compositor
+ * @param index -> layer index
+ * @param x&y -> new position on screen
+ * @return none
+ */
+void ST7789_compositorMoveLayer(ST7789_Compositor_t *comp, uint8_t index, int16_t x, int16_t y)
+{
+	if (comp == NULL || index >= comp->count) return;
 
-		// Check for line wrap
-		if (cursor_x + glyph->xOffset + glyph->width >= ST7789_WIDTH) {
-			cursor_x = 0;
-			cursor_y += font->yAdvance;
+	ST7789_Layer_t *layer = &comp->layers[index];
+	if (layer->x == x && layer->y == y) return;
 
-			// Stop if we've gone off bottom of screen
-			if (cursor_y >= ST7789_HEIGHT) {
-				break;
-			}
+	if (layer->visible) {
+		ST7789_compositorInvalidate(comp, layer->x, layer->y, layer->width, layer->height);
+		ST7789_compositorInvalidate(comp, x, y, layer->width, layer->height);
+	}
+	layer->x = x;
+	layer->y = y;
+}
 
-			// Skip spaces at beginning of new line
-			if (c == ' ') {
-				continue;
-			}
-		}
+/**
+ * @brief Show or hide a layer, damaging the area it covers
+ * @param comp -> compositor
+ * @param index -> layer index
+ * @param visible -> Whether the layer is shown
+ * @return none
+ * @note Closing a popup only recomposites the area below it
+ */
+void ST7789_compositorShowLayer(ST7789_Compositor_t *comp, uint8_t index, uint8_t visible)
+{
+	if (comp == NULL || index >= comp->count) return;
 
-		// Draw the character
-		ST7789_drawChar(cursor_x, cursor_y, c, font, color, bgcolor);
+	ST7789_Layer_t *layer = &comp->layers[index];
+	visible = visible ? 1 : 0;
+	if (layer->visible == visible) return;
 
-		// Advance cursor
-		cursor_x += glyph->xAdvance;
-	}
+	layer->visible = visible;
+	ST7789_compositorInvalidate(comp, layer->x, layer->y, layer->width, layer->height);
 }
 
 /**
- * @brief Calculate bounding box for a text string
- * @param str -> string to measure
- * @param font -> pointer to GFX font
- * @param w -> pointer to store calculated width
- * @param h -> pointer to store calculated height
+ * @brief Composite one row segment of all layers into a pixel buffer
+ * @param comp -> compositor
+ * @param dst -> destination pixels (RGB565, MCU byte order)
+ * @param x&y -> screen position of the first pixel
+ * @param w -> number of pixels
  * @return none
- * @note This function only calculates dimensions without rendering
  */
-void ST7789_getTextBounds(const char *str, const GFXfont *font, uint16_t *w, uint16_t *h)
+static void ST7789_CompositeRow(const ST7789_Compositor_t *comp, uint16_t *dst, int16_t x, int16_t y, uint16_t w)
 {
-	if (str == NULL || font == NULL || w == NULL || h == NULL) {
-		return;
+	for (uint16_t i = 0; i < w; i++) {
+		dst[i] = comp->background;
 	}
 
-	int16_t cursor_x = 0;
-	int16_t min_x = 0, max_x = 0;
-	int16_t min_y = 0, max_y = 0;
-	uint8_t first_char = 1;
+	for (uint8_t l = 0; l < comp->count; l++) {
+		const ST7789_Layer_t *layer = &comp->layers[l];
 
-	while (*str) {
-		char c = *str++;
+		if (!layer->visible || layer->pixels == NULL || layer->alpha == 0) continue;
+		if (y < layer->y || y >= layer->y + layer->height) continue;
 
-		// Check if character is in font range
-		if ((c < font->first) || (c > font->last)) {
-			continue;
-		}
+		// Horizontal overlap between the row segment and the layer
+		int32_t x0 = (x > layer->x) ? x : layer->x;
+		int32_t x1 = ((x + w) < (layer->x + layer->width)) ? (x + w) : (layer->x + layer->width);
+		if (x0 >= x1) continue;
 
-		// Get glyph for this character
-		GFXglyph *glyph = &font->glyph[c - font->first];
+		uint32_t src = (uint32_t)(y - layer->y) * layer->width + (x0 - layer->x);
+		uint16_t *out = &dst[x0 - x];
+		uint16_t count = x1 - x0;
 
-		if (first_char) {
-			// Initialize bounds with first character
-			min_x = cursor_x + glyph->xOffset;
-			max_x = min_x + glyph->width;
-			min_y = glyph->yOffset;
-			max_y = min_y + glyph->height;
-			first_char = 0;
-		} else {
-			// Expand bounds for subsequent characters
-			int16_t char_min_x = cursor_x + glyph->xOffset;
-			int16_t char_max_x = char_min_x + glyph->width;
-			int16_t char_min_y = glyph->yOffset;
-			int16_t char_max_y = char_min_y + glyph->height;
+		for (uint16_t i = 0; i < count; i++, src++) {
+			uint16_t color;
 
-			if (char_min_x < min_x) min_x = char_min_x;
-			if (char_max_x > max_x) max_x = char_max_x;
-			if (char_min_y < min_y) min_y = char_min_y;
-			if (char_max_y > max_y) max_y = char_max_y;
-		}
+			if (layer->format == ST7789_LAYER_INDEXED8) {
+				uint8_t index = ((const uint8_t*)layer->pixels)[src];
+				if (layer->use_key && index == layer->key) continue;
+				color = layer->palette[index];
+			} else {
+				color = ((const uint16_t*)layer->pixels)[src];
+				if (layer->use_key && color == layer->key) continue;
+			}
 
-		// Advance cursor
-		cursor_x += glyph->xAdvance;
+			out[i] = (layer->alpha == 255) ? color : ST7789_BlendColor(color, out[i], layer->alpha);
+		}
 	}
-
-	// Calculate final dimensions
-	*w = (uint16_t)(max_x - min_x);
-	*h = (uint16_t)(max_y - min_y);
 }
 
 /**
- * @brief Draw a filled Rectangle with single color
- * @param  x&y -> coordinates of the starting point
- * @param w&h -> width & height of the Rectangle
- * @param color -> color of the Rectangle
- * @return  none
+ * @brief Recomposite and send all damaged regions
+ * @param comp -> compositor
+ * @return none
+ * @note Regions are composited through st7789_disp_buf in tiles of as many rows as fit
  */
-void ST7789_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+void ST7789_compositorFlush(ST7789_Compositor_t *comp)
 {
 	if (!ST7789_isInitialized()) return;
+	if (comp == NULL) return;
 
-	uint32_t size;
-	uint32_t buffer_bytes;
-	uint32_t buffer_count;
-	uint32_t remainder;
-	uint16_t color_swapped;
-	uint16_t i;
-	uint32_t j;
+	for (uint8_t d = 0; d < comp->dirty_count; d++) {
+		int16_t x = comp->dirty[d].x, y = comp->dirty[d].y;
+		uint16_t w = comp->dirty[d].w, h = comp->dirty[d].h;
 
-	/* Check input parameters */
-	if (x >= ST7789_WIDTH || y >= ST7789_HEIGHT) {
-		return;
-	}
+		if (!ST7789_ClipArea(&x, &y, &w, &h)) continue;
 
-	/* Clip width and height to screen boundaries */
-	if ((x + w) > ST7789_WIDTH) {
-		w = ST7789_WIDTH - x;
-	}
-	if ((y + h) > ST7789_HEIGHT) {
-		h = ST7789_HEIGHT - y;
-	}
+		// Wide regions are split in columns narrower than the buffer
+		for (uint16_t tx = 0; tx < w; tx += st7789_disp_buf_size) {
+			uint16_t tile_w = ((w - tx) > st7789_disp_buf_size) ? st7789_disp_buf_size : (w - tx);
+			uint16_t rows = st7789_disp_buf_size / tile_w;
 
-	if (w == 0 || h == 0) {
-		return;
-	}
+			for (uint16_t ty = 0; ty < h; ty += rows) {
+				uint16_t tile_h = ((h - ty) > rows) ? rows : (h - ty);
+				uint32_t count = (uint32_t)tile_w * tile_h;
 
-	ST7789_Select();
+				for (uint16_t row = 0; row < tile_h; row++) {
+					ST7789_CompositeRow(comp, &st7789_disp_buf[row * tile_w], x + tx, y + ty + row, tile_w);
+				}
 
-	/* Calculate total size in bytes */
-	size = w * h * 2;
-	buffer_bytes = st7789_disp_buf_size * sizeof(uint16_t);
-	buffer_count = size / buffer_bytes;
-	remainder = size % buffer_bytes;
+				// Convert to big-endian in place
+				for (uint32_t i = 0; i < count; i++) {
+					uint16_t pixel = st7789_disp_buf[i];
+					st7789_disp_buf[i] = (pixel >> 8) | (pixel << 8);
+				}
 
-	/* Fill buffer with color in big-endian format */
-	color_swapped = (color >> 8) | (color << 8);
-	for (i = 0; i < st7789_disp_buf_size; i++) {
-		st7789_disp_buf[i] = color_swapped;
+				ST7789_Select();
+				ST7789_SetAddressWindow(x + tx, y + ty, x + tx + tile_w - 1, y + ty + tile_h - 1);
+				ST7789_WriteData((uint8_t*)st7789_disp_buf, count * 2);
+				ST7789_UnSelect();
+			}
+		}
 	}
 
-	/* Set address window and write data */
-	ST7789_SetAddressWindow(x, y, x + w - 1, y + h - 1);
-	for (j = 0; j < buffer_count; j++) {
-		ST7789_WriteData((uint8_t*)st7789_disp_buf, buffer_bytes);
-	}
+	comp->dirty_count = 0;
+}
 
-	if (remainder > 0) {
-		ST7789_WriteData((uint8_t*)st7789_disp_buf, remainder);
-	}
 
-	ST7789_UnSelect();
+/**
+ * @brief Check if two rectangles overlap
+ * @param a&b -> rectangles to test
+ * @return 1 if they share at least one pixel, 0 otherwise
+ */
+static uint8_t ST7789_RectOverlap(const ST7789_Rect_t *a, const ST7789_Rect_t *b)
+{
+	return (a->x < b->x + b->w) && (b->x < a->x + a->w) &&
+	       (a->y < b->y + b->h) && (b->y < a->y + a->h);
 }
 
 /**
- * @brief Draw a Triangle with single color
- * @param  xi&yi -> 3 coordinates of 3 top points.
- * @param color ->color of the lines
- * @return  none
+ * @brief Grow a rectangle to the bounding box of itself and another one
+ * @param a -> rectangle to grow
+ * @param b -> rectangle to include
+ * @return none
  */
-void ST7789_drawTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint16_t color)
+static void ST7789_RectUnion(ST7789_Rect_t *a, const ST7789_Rect_t *b)
 {
-	if (!ST7789_isInitialized()) return;
-	ST7789_Select();
-	/* Draw lines */
-	ST7789_DrawLine_Internal(x1, y1, x2, y2, color);
-	ST7789_DrawLine_Internal(x2, y2, x3, y3, color);
-	ST7789_DrawLine_Internal(x3, y3, x1, y1, color);
-	ST7789_UnSelect();
+	int32_t x0 = (a->x < b->x) ? a->x : b->x;
+	int32_t y0 = (a->y < b->y) ? a->y : b->y;
+	int32_t x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+	int32_t y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+
+	a->x = x0;
+	a->y = y0;
+	a->w = x1 - x0;
+	a->h = y1 - y0;
 }
 
 /**
- * @brief Draw a filled Triangle with single color
- * @param  xi&yi -> 3 coordinates of 3 top points.
- * @param color ->color of the triangle
- * @return  none
+ * @brief Initialize a sprite
+ * @param sprite -> sprite to initialize
+ * @param image -> w * h pixels (RGB565, MCU byte order)
+ * @param w&h -> width & height of the sprite
+ * @param key -> transparent color
+ * @param save_under -> w * h pixels to keep the background under the sprite,
+ *                      may be NULL when updates use a background canvas
+ * @return none
+ * @note The sprite starts hidden at (0, 0)
  */
-void ST7789_fillTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint16_t color)
+void ST7789_spriteInit(ST7789_Sprite_t *sprite, const uint16_t *image, uint16_t w, uint16_t h, uint16_t key, uint16_t *save_under)
 {
-	if (!ST7789_isInitialized()) return;
-	ST7789_Select();
-	int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
-			yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
-			curpixel = 0;
+	if (sprite == NULL) return;
+
+	memset(sprite, 0, sizeof(*sprite));
+	sprite->image = image;
+	sprite->save_under = save_under;
+	sprite->width = w;
+	sprite->height = h;
+	sprite->key = key;
+}
+
+/**
+ * @brief Set the position of a sprite for the next update
+ * @param sprite -> sprite to move
+ * @param x&y -> new top-left corner on screen
+ * @return none
+ */
+void ST7789_spriteMove(ST7789_Sprite_t *sprite, int16_t x, int16_t y)
+{
+	if (sprite == NULL) return;
+	sprite->x = x;
+	sprite->y = y;
+}
 
-	deltax = abs(x2 - x1);
-	deltay = abs(y2 - y1);
-	x = x1;
-	y = y1;
+/**
+ * @brief Show or hide a sprite on the next update
+ * @param sprite -> sprite to show or hide
+ * @param visible -> Whether the sprite is shown
+ * @return none
+ */
+void ST7789_spriteShow(ST7789_Sprite_t *sprite, uint8_t visible)
+{
+	if (sprite == NULL) return;
+	sprite->visible = visible ? 1 : 0;
+}
 
-	if (x2 >= x1) {
-		xinc1 = 1;
-		xinc2 = 1;
-	}
-	else {
-		xinc1 = -1;
-		xinc2 = -1;
-	}
+/* Sprite operations on a tile of pixels */
+typedef enum {
+	ST7789_SPRITE_RESTORE,
+	ST7789_SPRITE_CAPTURE,
+	ST7789_SPRITE_DRAW
+} ST7789_SpriteOp_t;
 
-	if (y2 >= y1) {
-		yinc1 = 1;
-		yinc2 = 1;
-	}
-	else {
-		yinc1 = -1;
-		yinc2 = -1;
+/**
+ * @brief Apply a sprite operation to the part of a tile the sprite covers
+ * @param tile -> screen rectangle held in buf
+ * @param buf -> tile pixels (RGB565, MCU byte order)
+ * @param sprite -> sprite
+ * @param sx&sy -> sprite position on screen
+ * @param op -> restore the save-under, capture it, or draw the sprite
+ * @return none
+ */
+static void ST7789_SpriteTileOp(const ST7789_Rect_t *tile, uint16_t *buf, ST7789_Sprite_t *sprite,
+                                int16_t sx, int16_t sy, ST7789_SpriteOp_t op)
+{
+	int32_t x0 = (sx > tile->x) ? sx : tile->x;
+	int32_t y0 = (sy > tile->y) ? sy : tile->y;
+	int32_t x1 = (sx + sprite->width < tile->x + tile->w) ? sx + sprite->width : tile->x + tile->w;
+	int32_t y1 = (sy + sprite->height < tile->y + tile->h) ? sy + sprite->height : tile->y + tile->h;
+
+	for (int32_t y = y0; y < y1; y++) {
+		uint16_t *dst = &buf[(y - tile->y) * tile->w + (x0 - tile->x)];
+		uint32_t src = (uint32_t)(y - sy) * sprite->width + (x0 - sx);
+
+		for (int32_t x = x0; x < x1; x++, dst++, src++) {
+			switch (op) {
+			case ST7789_SPRITE_RESTORE:
+				*dst = sprite->save_under[src];
+				break;
+			case ST7789_SPRITE_CAPTURE:
+				sprite->save_under[src] = *dst;
+				break;
+			default:
+				if (sprite->image[src] != sprite->key) {
+					*dst = sprite->image[src];
+				}
+				break;
+			}
+		}
 	}
+}
 
-	if (deltax >= deltay) {
-		xinc1 = 0;
-		yinc2 = 0;
-		den = deltax;
-		num = deltax / 2;
-		numadd = deltay;
-		numpixels = deltax;
+/**
+ * @brief Fetch the background of a tile
+ * @param tile -> screen rectangle to fetch
+ * @param buf -> destination pixels (RGB565, MCU byte order)
+ * @param background -> canvas at the screen origin, NULL to read GRAM back
+ * @return none
+ * @note Parts of the tile outside the canvas are read back from GRAM
+ */
+static void ST7789_FetchBackground(const ST7789_Rect_t *tile, uint16_t *buf, const ST7789_Canvas_t *background)
+{
+	if (background == NULL ||
+	    tile->x + tile->w > background->width || tile->y + tile->h > background->height) {
+		ST7789_ReadWindow(tile->x, tile->y, tile->x + tile->w - 1, tile->y + tile->h - 1,
+		                  buf, (uint32_t)tile->w * tile->h);
+		if (background == NULL) return;
 	}
-	else {
-		xinc2 = 0;
-		yinc1 = 0;
-		den = deltay;
-		num = deltay / 2;
-		numadd = deltax;
-		numpixels = deltay;
+
+	int32_t x1 = (tile->x + tile->w < background->width) ? tile->x + tile->w : background->width;
+	int32_t y1 = (tile->y + tile->h < background->height) ? tile->y + tile->h : background->height;
+	if (tile->x >= x1) return;
+
+	for (int32_t y = tile->y; y < y1; y++) {
+		memcpy(&buf[(y - tile->y) * tile->w], &background->buf[(uint32_t)y * background->width + tile->x],
+		       (x1 - tile->x) * sizeof(uint16_t));
 	}
+}
+
+/**
+ * @brief Recompose a screen window of sprites through the display buffer
+ * @param win -> screen window, already clipped
+ * @param sprites -> sprite array
+ * @param count -> number of sprites
+ * @param background -> background canvas, NULL to read GRAM back
+ * @param restore -> Whether sprites drawn in GRAM are peeled off
+ * @param draw -> Whether visible sprites are captured and drawn
+ * @return none
+ * @note Windows larger than the buffer are processed in tiles.
+ */
+static void ST7789_SpriteWindow(const ST7789_Rect_t *win, ST7789_Sprite_t *sprites, uint8_t count,
+                                const ST7789_Canvas_t *background, uint8_t restore, uint8_t draw)
+{
+	for (uint16_t tx = 0; tx < win->w; tx += st7789_disp_buf_size) {
+		uint16_t tile_w = ((win->w - tx) > st7789_disp_buf_size) ? st7789_disp_buf_size : (win->w - tx);
+		uint16_t rows = st7789_disp_buf_size / tile_w;
+
+		for (uint16_t ty = 0; ty < win->h; ty += rows) {
+			ST7789_Rect_t tile = {win->x + tx, win->y + ty, tile_w, ((win->h - ty) > rows) ? rows : (win->h - ty)};
+			uint32_t pixels = (uint32_t)tile.w * tile.h;
+
+			ST7789_FetchBackground(&tile, st7789_disp_buf, background);
+
+			// GRAM holds the sprites as drawn, peel them off top to bottom
+			if (restore) {
+				for (uint8_t i = count; i-- > 0;) {
+					ST7789_Sprite_t *sp = &sprites[i];
+					if (sp->drawn && sp->save_under != NULL) {
+						ST7789_SpriteTileOp(&tile, st7789_disp_buf, sp, sp->drawn_x, sp->drawn_y, ST7789_SPRITE_RESTORE);
+					}
+				}
+			}
 
-	for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-		ST7789_DrawLine_Internal(x, y, x3, y3, color);
+			for (uint8_t i = 0; draw && i < count; i++) {
+				ST7789_Sprite_t *sp = &sprites[i];
+				if (!sp->visible || sp->image == NULL) continue;
+				if (sp->save_under != NULL) {
+					ST7789_SpriteTileOp(&tile, st7789_disp_buf, sp, sp->x, sp->y, ST7789_SPRITE_CAPTURE);
+				}
+				ST7789_SpriteTileOp(&tile, st7789_disp_buf, sp, sp->x, sp->y, ST7789_SPRITE_DRAW);
+			}
+
+			// Convert to big-endian in place
+			for (uint32_t i = 0; i < pixels; i++) {
+				uint16_t pixel = st7789_disp_buf[i];
+				st7789_disp_buf[i] = (pixel >> 8) | (pixel << 8);
+			}
 
-		num += numadd;
-		if (num >= den) {
-			num -= den;
-			x += xinc1;
-			y += yinc1;
+			ST7789_Select();
+			ST7789_SetAddressWindow(tile.x, tile.y, tile.x + tile.w - 1, tile.y + tile.h - 1);
+			ST7789_WriteData((uint8_t*)st7789_disp_buf, pixels * 2);
+			ST7789_UnSelect();
 		}
-		x += xinc2;
-		y += yinc2;
 	}
-	ST7789_UnSelect();
 }
 
 /**
- * @brief Draw a Filled circle with single color
- * @param x0&y0 -> coordinate of circle center
- * @param r -> radius of circle
- * @param color -> color of circle
- * @return  none
+ * @brief Redraw moved, shown and hidden sprites
+ * @param sprites -> sprite array, drawn in order (last on top)
+ * @param count -> number of sprites
+ * @param background -> canvas holding the screen background at the screen origin,
+ *                      NULL to read the background back from GRAM
+ * @return none
+ * @note Old and new bounding boxes of changed sprites are merged into union windows.
+ *       Each window is read, restored from the save-unders, redrawn and sent once,
+ *       so moving a sprite costs about two sprite-sized pushes. Sprites in a window
+ *       that didn't change are restored and drawn again in the same pass.
+ *       Without a canvas, a window larger than the buffer or a sprite jumping away
+ *       from its old position falls back to erasing every window before redrawing,
+ *       since the save-under has to be restored before it is captured again.
  */
-void ST7789_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+void ST7789_spritesUpdate(ST7789_Sprite_t *sprites, uint8_t count, const ST7789_Canvas_t *background)
 {
 	if (!ST7789_isInitialized()) return;
-	ST7789_Select();
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
-
-	ST7789_DrawPixel_Internal(x0, y0 + r, color);
-	ST7789_DrawPixel_Internal(x0, y0 - r, color);
-	ST7789_DrawPixel_Internal(x0 + r, y0, color);
-	ST7789_DrawPixel_Internal(x0 - r, y0, color);
-	ST7789_DrawLine_Internal(x0 - r, y0, x0 + r, y0, color);
+	if (sprites == NULL) return;
 
-	while (x < y) {
-		if (f >= 0) {
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
+	ST7789_Rect_t windows[ST7789_MAX_DIRTY_RECTS];
+	uint8_t window_count = 0;
+	uint8_t split = 0;
+
+	// Collect the damaged area of every changed sprite
+	for (uint8_t i = 0; i < count; i++) {
+		ST7789_Sprite_t *sp = &sprites[i];
+		ST7789_Rect_t damage = {sp->x, sp->y, sp->width, sp->height};
+		ST7789_Rect_t old = {sp->drawn_x, sp->drawn_y, sp->width, sp->height};
+
+		if (sp->drawn == sp->visible && (!sp->drawn || (sp->x == sp->drawn_x && sp->y == sp->drawn_y))) {
+			continue;
 		}
-		x++;
-		ddF_x += 2;
-		f += ddF_x;
 
-		ST7789_DrawLine_Internal(x0 - x, y0 + y, x0 + x, y0 + y, color);
-		ST7789_DrawLine_Internal(x0 + x, y0 - y, x0 - x, y0 - y, color);
+		if (!sp->visible) {
+			damage = old;
+		} else if (sp->drawn) {
+			if (ST7789_RectOverlap(&damage, &old)) {
+				ST7789_RectUnion(&damage, &old);
+			} else {
+				split = 1;
+				if (window_count < ST7789_MAX_DIRTY_RECTS) {
+					windows[window_count++] = old;
+				} else {
+					ST7789_RectUnion(&windows[window_count - 1], &old);
+				}
+			}
+		}
 
-		ST7789_DrawLine_Internal(x0 + y, y0 + x, x0 - y, y0 + x, color);
-		ST7789_DrawLine_Internal(x0 + y, y0 - x, x0 - y, y0 - x, color);
+		if (window_count < ST7789_MAX_DIRTY_RECTS) {
+			windows[window_count++] = damage;
+		} else {
+			ST7789_RectUnion(&windows[window_count - 1], &damage);
+		}
+	}
+
+	// Merge overlapping windows so each area is sent once
+	uint8_t merged;
+	do {
+		merged = 0;
+		for (uint8_t i = 0; i < window_count; i++) {
+			for (uint8_t j = i + 1; j < window_count; j++) {
+				if (ST7789_RectOverlap(&windows[i], &windows[j])) {
+					ST7789_RectUnion(&windows[i], &windows[j]);
+					windows[j--] = windows[--window_count];
+					merged = 1;
+				}
+			}
+		}
+	} while (merged);
+
+	// Clip windows to the screen, dropping the ones left empty
+	for (uint8_t i = 0; i < window_count; i++) {
+		int16_t x = windows[i].x < 0 ? 0 : windows[i].x;
+		int16_t y = windows[i].y < 0 ? 0 : windows[i].y;
+		int32_t x1 = windows[i].x + windows[i].w, y1 = windows[i].y + windows[i].h;
+		uint16_t w = (x1 > x) ? x1 - x : 0, h = (y1 > y) ? y1 - y : 0;
+
+		if (w == 0 || h == 0 || !ST7789_ClipArea(&x, &y, &w, &h)) {
+			windows[i--] = windows[--window_count];
+			continue;
+		}
+		windows[i].x = x;
+		windows[i].y = y;
+		windows[i].w = w;
+		windows[i].h = h;
+		if ((uint32_t)w * h > st7789_disp_buf_size) {
+			split = 1;
+		}
+	}
+
+	if (background != NULL) {
+		split = 0;
+	} else if (split) {
+		for (uint8_t i = 0; i < window_count; i++) {
+			ST7789_SpriteWindow(&windows[i], sprites, count, NULL, 1, 0);
+		}
+		// GRAM no longer holds sprites inside the windows
+		for (uint8_t i = 0; i < window_count; i++) {
+			ST7789_SpriteWindow(&windows[i], sprites, count, NULL, 0, 1);
+		}
+	}
+
+	if (!split) {
+		for (uint8_t i = 0; i < window_count; i++) {
+			ST7789_SpriteWindow(&windows[i], sprites, count, background, background == NULL, 1);
+		}
 	}
-	ST7789_UnSelect();
-}
 
+	for (uint8_t i = 0; i < count; i++) {
+		sprites[i].drawn = sprites[i].visible;
+		sprites[i].drawn_x = sprites[i].x;
+		sprites[i].drawn_y = sprites[i].y;
+	}
+}
 
+#ifdef ST7789_USE_BUS_STATS
 /**
- * @brief Open/Close tearing effect line
- * @param tear -> Whether to tear
+ * @brief Get bus traffic counters
+ * @param stats -> pointer to store the counters
  * @return none
  */
-void ST7789_tearEffect(uint8_t tear)
+void ST7789_getBusStats(ST7789_BusStats_t *stats)
 {
-	if (!ST7789_isInitialized()) return;
-	ST7789_Select();
-	ST7789_WriteCommand(tear ? 0x35 /* TEON */ : 0x34 /* TEOFF */);
-	ST7789_UnSelect();
+	if (stats == NULL) return;
+	*stats = st7789_bus_stats;
 }
 
+/**
+ * @brief Reset bus traffic counters
+ * @return none
+ */
+void ST7789_resetBusStats(void)
+{
+	memset(&st7789_bus_stats, 0, sizeof(st7789_bus_stats));
+}
+#endif
 
 /**
  * @brief A Simple test function for ST7789
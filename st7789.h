@@ -27,9 +27,131 @@ typedef enum {
 	ST7789_OK = 0,
 	ST7789_ERR_BUFFER_ALLOC = -1,
 	ST7789_ERR_ALREADY_INIT = -2,
-	ST7789_ERR_INVALID_PARAM = -3
+	ST7789_ERR_INVALID_PARAM = -3,
+	ST7789_ERR_OVERFLOW = -4
 } ST7789_Status_t;
 
+/* Flush started from the TE interrupt by ST7789_vsyncSchedule() */
+typedef void (*ST7789_FlushFn_t)(void *ctx);
+
+/* Tearing effect (vsync) statistics */
+typedef struct {
+	uint32_t frames;        // Frames flushed between ST7789_vsyncBegin() and ST7789_vsyncEnd() or scheduled
+	uint32_t missed;        // Frames still transferring when the next TE pulse arrived
+	uint32_t timeouts;      // Waits that gave up because no TE pulse arrived
+	uint32_t last_wait_ms;  // Time spent waiting for the last TE pulse
+} ST7789_VsyncStats_t;
+
+/* Frame pacing statistics */
+typedef struct {
+	uint32_t frames;         // Frames paced between ST7789_frameBegin() and ST7789_frameEnd()
+	uint32_t dropped;        // Refresh periods skipped because a frame overran its budget
+	uint32_t frame_time_ms;  // Render + flush time of the last frame
+	int32_t slack_ms;        // Budget left in the last frame (negative when over budget)
+} ST7789_FrameStats_t;
+
+/* Rectangle in screen coordinates */
+typedef struct {
+	int16_t x;
+	int16_t y;
+	uint16_t w;
+	uint16_t h;
+} ST7789_Rect_t;
+
+/* Point for polylines and polygons */
+typedef struct {
+	int16_t x;
+	int16_t y;
+} ST7789_Point_t;
+
+/* Polygon fill rules */
+typedef enum {
+	ST7789_FILL_EVEN_ODD,       // Inside where an odd number of edges is crossed
+	ST7789_FILL_NONZERO         // Inside where edges don't wind to zero
+} ST7789_FillRule_t;
+
+/* Stroke joins */
+typedef enum {
+	ST7789_JOIN_MITER,          // Outer edges extended to a point
+	ST7789_JOIN_ROUND,          // Disc around the shared point
+	ST7789_JOIN_BEVEL           // Outer corners cut straight
+} ST7789_LineJoin_t;
+
+/* Stroke caps */
+typedef enum {
+	ST7789_CAP_BUTT,            // Stroke ends at the end point
+	ST7789_CAP_ROUND            // Half disc past the end point
+} ST7789_LineCap_t;
+
+/* Bus traffic counters */
+typedef struct {
+	uint32_t commands;          // Command bytes sent
+	uint32_t windows;           // Address windows opened (RAMWR)
+	uint32_t bytes;             // Parameter and pixel data bytes sent
+} ST7789_BusStats_t;
+
+/* Off-screen RGB565 canvas (MCU byte order) */
+typedef struct {
+	uint16_t *buf;              // width * height pixels
+	uint16_t width;
+	uint16_t height;
+} ST7789_Canvas_t;
+
+/* Alpha channel formats for blending blits */
+typedef enum {
+	ST7789_ALPHA_CONST,         // No alpha channel, constant opacity only
+	ST7789_ALPHA_A4,            // 4-bit alpha, high nibble first, rows padded to a byte
+	ST7789_ALPHA_A8             // 8-bit alpha, one byte per pixel
+} ST7789_AlphaFormat_t;
+
+/* Sprite with save-under background */
+typedef struct {
+	const uint16_t *image;      // width * height pixels, RGB565 in MCU byte order
+	uint16_t *save_under;       // width * height pixels saved from under the sprite
+	uint16_t width;
+	uint16_t height;
+	uint16_t key;               // Transparent color
+	int16_t x;                  // Position applied on the next update
+	int16_t y;
+	uint8_t visible;
+	int16_t drawn_x;            // Position currently on screen (managed by the driver)
+	int16_t drawn_y;
+	uint8_t drawn;
+} ST7789_Sprite_t;
+
+/* Layer pixel formats */
+typedef enum {
+	ST7789_LAYER_RGB565 = 0,    // uint16_t pixels, RGB565 in MCU byte order
+	ST7789_LAYER_INDEXED8 = 1   // uint8_t palette indices
+} ST7789_LayerFormat_t;
+
+/* Compositor layer */
+typedef struct {
+	const void *pixels;         // width * height pixels in layer format
+	const uint16_t *palette;    // Palette for ST7789_LAYER_INDEXED8
+	int16_t x;                  // Position on screen
+	int16_t y;
+	uint16_t width;
+	uint16_t height;
+	ST7789_LayerFormat_t format;
+	uint16_t key;               // Transparent color (RGB565) or palette index
+	uint8_t use_key;            // Whether pixels equal to key are transparent
+	uint8_t alpha;              // Layer opacity (0-255)
+	uint8_t visible;
+} ST7789_Layer_t;
+
+/* Maximum number of separate damaged regions tracked by a compositor */
+#define ST7789_MAX_DIRTY_RECTS 8
+
+/* Layer compositor */
+typedef struct {
+	ST7789_Layer_t *layers;     // Layer stack, bottom layer first
+	uint8_t count;
+	uint16_t background;        // Color below the bottom layer
+	ST7789_Rect_t dirty[ST7789_MAX_DIRTY_RECTS];
+	uint8_t dirty_count;
+} ST7789_Compositor_t;
+
 /* choose a Hardware SPI port to use. */
 #define ST7789_SPI_PORT hspi1
 extern SPI_HandleTypeDef ST7789_SPI_PORT;
@@ -37,6 +159,38 @@ extern SPI_HandleTypeDef ST7789_SPI_PORT;
 /* choose whether use DMA or not */
 #define ST7789_USE_DMA
 
+/* Count commands, address windows and data bytes sent (ST7789_getBusStats) */
+//#define ST7789_USE_BUS_STATS
+
+/* TE pin on an EXTI line, lets ST7789_vsyncIRQHandler() count flushes overrunning the next pulse */
+//#define ST7789_TE_PIN ST7789_TE_Pin
+
+/* SPI clock prescaler while reading GRAM back (RAMRD needs a slower clock than writes) */
+#define ST7789_SPI_READ_PRESCALER SPI_BAUDRATEPRESCALER_16
+
+/* Keyed blit rows with more opaque runs than this are read back and rewritten in one window */
+#define ST7789_KEY_MAX_RUNS 4
+
+/* Longest miter of a stroke join in stroke widths, sharper corners are beveled (at most 6) */
+#define ST7789_MITER_LIMIT 4
+
+/* Most non-horizontal edges ST7789_fillPolygon() takes, its edge table is static (about 66 bytes per edge) */
+#define ST7789_MAX_POLY_EDGES 32
+
+/* Spans the static stack of ST7789_canvasFloodFill() holds (8 bytes per span) */
+#define ST7789_FLOOD_STACK_SPANS 128
+
+/* Canvas passes ST7789_canvasFloodFill() spends looking for a free marker color after an overflow */
+#define ST7789_FLOOD_MARKER_PASSES 4
+
+/* Largest distance between a Bezier curve and its flattened segments (1/16 pixel).
+ * Thin curves round the segment ends to whole pixels, so their pixels can sit up
+ * to about this plus one pixel off the exact curve. Thick curves keep 1/16 pixel. */
+#define ST7789_CURVE_TOLERANCE_Q4 4
+
+/* Longest wait for a TE pulse before giving up (ms) */
+#define ST7789_VSYNC_TIMEOUT_MS 50
+
 /* Pin connection*/
 #define ST7789_RST_PORT ST7789_RST_GPIO_Port
 #define ST7789_RST_PIN  ST7789_RST_Pin
@@ -62,31 +216,139 @@ uint16_t ST7789_height(void);
 uint8_t ST7789_getRotation(void);
 ST7789_DisplayType_t ST7789_getDisplayType(void);
 void ST7789_fillScreen(uint16_t color);
-void ST7789_drawPixel(uint16_t x, uint16_t y, uint16_t color);
+void ST7789_drawPixel(int16_t x, int16_t y, uint16_t color);
+void ST7789_drawPixels(const ST7789_Point_t *points, uint16_t count, const uint16_t *colors, uint16_t color);
 
 /* Graphical functions. */
-void ST7789_drawLine(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
-void ST7789_drawFastHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color);
-void ST7789_drawFastVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color);
-void ST7789_drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
-void ST7789_drawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color);
-void ST7789_drawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data);
+void ST7789_drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+void ST7789_drawLineAA(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color, uint16_t bgcolor);
+void ST7789_drawLineAAReadback(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+void ST7789_canvasDrawLineAA(const ST7789_Canvas_t *canvas, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+void ST7789_drawFastHLine(int16_t x, int16_t y, uint16_t w, uint16_t color);
+void ST7789_drawFastVLine(int16_t x, int16_t y, uint16_t h, uint16_t color);
+void ST7789_drawRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+void ST7789_drawCircle(int16_t x0, int16_t y0, uint16_t r, uint16_t color);
+void ST7789_drawImage(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data);
 void ST7789_invertColors(uint8_t invert);
+void ST7789_setClipRect(int16_t x, int16_t y, uint16_t w, uint16_t h);
+void ST7789_resetClipRect(void);
+
+/* Readback functions. */
+uint16_t ST7789_readPixel(uint16_t x, uint16_t y);
+ST7789_Status_t ST7789_readRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *dest);
+
+/* Blitting functions. */
+void ST7789_drawImageAlpha(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data,
+                           const uint8_t *alpha, ST7789_AlphaFormat_t format, uint8_t opacity);
+void ST7789_canvasDrawImageAlpha(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                                 const uint16_t *data, const uint8_t *alpha, ST7789_AlphaFormat_t format, uint8_t opacity);
+void ST7789_drawImageKeyed(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data, uint16_t key);
+void ST7789_canvasDrawImageKeyed(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                                 const uint16_t *data, uint16_t key);
+void ST7789_drawBitmap1bpp(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *bitmap,
+                           uint16_t color, uint16_t bgcolor);
+void ST7789_drawBitmap1bppTransparent(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *bitmap,
+                                      uint16_t color);
+
+/* Canvas functions. */
+ST7789_Status_t ST7789_canvasFloodFill(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t color,
+                                       ST7789_Rect_t *damage);
+void ST7789_canvasCopyRect(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                           int16_t dst_x, int16_t dst_y, ST7789_Rect_t *damage);
+void ST7789_canvasFlush(const ST7789_Canvas_t *canvas, int16_t x, int16_t y, const ST7789_Rect_t *rect);
 
 /* Text functions. */
-void ST7789_drawChar(uint16_t x, uint16_t y, char ch, const GFXfont *font, uint16_t color, uint16_t bgcolor);
-void ST7789_drawString(uint16_t x, uint16_t y, const char *str, const GFXfont *font, uint16_t color, uint16_t bgcolor);
+void ST7789_drawChar(int16_t x, int16_t y, char ch, const GFXfont *font, uint16_t color, uint16_t bgcolor);
+void ST7789_drawString(int16_t x, int16_t y, const char *str, const GFXfont *font, uint16_t color, uint16_t bgcolor);
 void ST7789_getTextBounds(const char *str, const GFXfont *font, uint16_t *w, uint16_t *h);
 
 /* Extended Graphical functions. */
-void ST7789_fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
-void ST7789_drawTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint16_t color);
-void ST7789_fillTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint16_t color);
+void ST7789_fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+void ST7789_fillRectGradient(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color0, uint16_t color1,
+                             int16_t angle, uint8_t dither);
+void ST7789_fillRectRadialGradient(int16_t x, int16_t y, uint16_t w, uint16_t h, int16_t cx, int16_t cy,
+                                   uint16_t radius, uint16_t color0, uint16_t color1, uint8_t dither);
+void ST7789_drawTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint16_t color);
+void ST7789_drawPolyline(const ST7789_Point_t *points, uint16_t count, uint16_t color);
+void ST7789_fillTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint16_t color);
+void ST7789_drawThickLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t width,
+                          ST7789_LineCap_t cap, uint16_t color);
+void ST7789_drawThickPolyline(const ST7789_Point_t *points, uint16_t count, uint8_t width,
+                              ST7789_LineJoin_t join, ST7789_LineCap_t cap, uint16_t color);
+void ST7789_drawQuadBezier(int16_t x0, int16_t y0, int16_t cx, int16_t cy, int16_t x1, int16_t y1,
+                           uint8_t width, ST7789_LineCap_t cap, uint16_t color);
+void ST7789_drawCubicBezier(int16_t x0, int16_t y0, int16_t cx0, int16_t cy0, int16_t cx1, int16_t cy1,
+                            int16_t x1, int16_t y1, uint8_t width, ST7789_LineCap_t cap, uint16_t color);
+void ST7789_fillConvexPolygon(const ST7789_Point_t *points, uint16_t count, uint16_t color);
+ST7789_Status_t ST7789_fillPolygon(const ST7789_Point_t *points, uint16_t count, ST7789_FillRule_t rule, uint16_t color);
 void ST7789_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void ST7789_fillEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry, uint16_t color);
+void ST7789_fillRoundRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color);
+void ST7789_fillCircleAA(int16_t x0, int16_t y0, uint16_t r, uint16_t color, uint16_t bgcolor);
+void ST7789_drawRingAA(int16_t x0, int16_t y0, uint16_t r, uint16_t thickness, uint16_t color, uint16_t bgcolor);
+void ST7789_drawArcAA(int16_t x0, int16_t y0, uint16_t r, uint16_t thickness, int16_t start_angle, int16_t end_angle,
+                      uint16_t color, uint16_t bgcolor);
+
+/* Compositor functions. */
+void ST7789_compositorInit(ST7789_Compositor_t *comp, ST7789_Layer_t *layers, uint8_t count, uint16_t background);
+void ST7789_compositorInvalidate(ST7789_Compositor_t *comp, int16_t x, int16_t y, uint16_t w, uint16_t h);
+void ST7789_compositorInvalidateLayer(ST7789_Compositor_t *comp, uint8_t index, int16_t x, int16_t y, uint16_t w, uint16_t h);
+void ST7789_compositorMoveLayer(ST7789_Compositor_t *comp, uint8_t index, int16_t x, int16_t y);
+void ST7789_compositorShowLayer(ST7789_Compositor_t *comp, uint8_t index, uint8_t visible);
+void ST7789_compositorFlush(ST7789_Compositor_t *comp);
+
+/* Sprite functions. */
+void ST7789_spriteInit(ST7789_Sprite_t *sprite, const uint16_t *image, uint16_t w, uint16_t h, uint16_t key, uint16_t *save_under);
+void ST7789_spriteMove(ST7789_Sprite_t *sprite, int16_t x, int16_t y);
+void ST7789_spriteShow(ST7789_Sprite_t *sprite, uint8_t visible);
+void ST7789_spritesUpdate(ST7789_Sprite_t *sprites, uint8_t count, const ST7789_Canvas_t *background);
+
+/* Scrolling functions. */
+ST7789_Status_t ST7789_setScrollArea(uint16_t top_fixed, uint16_t bottom_fixed);
+void ST7789_setScrollOffset(uint16_t offset);
+uint16_t ST7789_getScrollOffset(void);
+uint16_t ST7789_scrollMapLine(uint16_t screen_line);
+void ST7789_scroll(int16_t lines, uint16_t color);
+
+/* Page flipping functions. */
+ST7789_Status_t ST7789_pageFlipEnable(uint16_t band_start, uint16_t band_lines);
+void ST7789_pageFlipDisable(void);
+void ST7789_pageFlipDrawBack(void);
+void ST7789_pageFlip(void);
+
+/* Power and display mode functions. */
+ST7789_Status_t ST7789_setPartialArea(uint16_t start, uint16_t lines);
+void ST7789_setNormalMode(void);
+void ST7789_setIdleMode(uint8_t idle);
 
 /* Command functions */
 void ST7789_tearEffect(uint8_t tear);
 
+/* Tearing effect synchronization functions. */
+void ST7789_vsyncEnable(uint16_t scanline);
+void ST7789_vsyncDisable(void);
+void ST7789_vsyncIRQHandler(void);
+uint8_t ST7789_vsyncBegin(void);
+void ST7789_vsyncEnd(void);
+ST7789_Status_t ST7789_vsyncSchedule(ST7789_FlushFn_t flush, void *ctx);
+uint8_t ST7789_vsyncPending(void);
+void ST7789_getVsyncStats(ST7789_VsyncStats_t *stats);
+void ST7789_resetVsyncStats(void);
+
+/* Frame rate and pacing functions. */
+uint8_t ST7789_setFrameRate(uint8_t hz);
+uint8_t ST7789_getFrameRate(void);
+void ST7789_frameBegin(void);
+void ST7789_frameEnd(void);
+void ST7789_getFrameStats(ST7789_FrameStats_t *stats);
+void ST7789_resetFrameStats(void);
+
+#ifdef ST7789_USE_BUS_STATS
+/* Bus statistics functions. */
+void ST7789_getBusStats(ST7789_BusStats_t *stats);
+void ST7789_resetBusStats(void);
+#endif
+
 /* Simple test function. */
 void ST7789_test(void);
 
@@ -54,11 +54,18 @@
  * ============================================================================ */
 #define ST7789_PTLAR   0x30  /* Partial Area */
 
+/* ============================================================================
+ * Vertical Scrolling Control
+ * ============================================================================ */
+#define ST7789_VSCRDEF 0x33  /* Vertical Scrolling Definition */
+#define ST7789_VSCSAD  0x37  /* Vertical Scroll Start Address of RAM */
+
 /* ============================================================================
  * Tearing Effect Control
  * ============================================================================ */
 #define ST7789_TEOFF   0x34  /* Tearing Effect Line Off */
 #define ST7789_TEON    0x35  /* Tearing Effect Line On */
+#define ST7789_STE     0x44  /* Set Tear Scanline */
 
 /* ============================================================================
  * Memory Access Control
@@ -66,6 +73,12 @@
 #define ST7789_MADCTL  0x36  /* Memory Data Access Control */
 #define ST7789_COLMOD  0x3A  /* Interface Pixel Format */
 
+/* ============================================================================
+ * Idle Mode Control
+ * ============================================================================ */
+#define ST7789_IDMOFF  0x38  /* Idle Mode Off */
+#define ST7789_IDMON   0x39  /* Idle Mode On (8-color) */
+
 /* ============================================================================
  * Frame Rate Control
  * ============================================================================ */